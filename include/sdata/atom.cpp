@@ -0,0 +1,135 @@
+#include "atom.hpp"
+#include <array>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace sdata {
+
+namespace {
+
+using Interned = Atom::Interned;
+
+struct Hash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view id) const {
+    return std::hash<std::string_view> {}(id);
+  }
+
+  size_t operator()(const Interned &interned) const {
+    return (*this)(interned.id);
+  }
+};
+
+struct Equal {
+  using is_transparent = void;
+
+  template<typename A, typename B>
+  bool operator()(const A &a, const B &b) const {
+    return view(a) == view(b);
+  }
+
+  static std::string_view view(std::string_view id) {
+    return id;
+  }
+
+  static std::string_view view(const Interned &interned) {
+    return interned.id;
+  }
+};
+
+struct Table {
+  std::shared_mutex mutex;
+  std::unordered_set<Interned, Hash, Equal> atoms;
+  size_t limit = std::numeric_limits<size_t>::max();
+};
+
+// Never destroyed, the atoms of the static nodes outlive the other static objects
+Table &table() {
+  static Table *table = new Table {};
+  return *table;
+}
+
+// Recently used atoms of the thread, most identifiers repeat and skip the table lock
+constexpr size_t CACHE_SIZE = 256;
+thread_local std::array<const Interned *, CACHE_SIZE> cache {};
+
+}  // namespace
+
+Atom::Atom(std::string_view id) {
+  if (id.empty()) {
+    return;
+  }
+
+  size_t hash = Hash {}(id);
+  const Interned *&cached = cache[hash % CACHE_SIZE];
+
+  if (cached && cached->id == id) {
+    m_interned = cached;
+    return;
+  }
+
+  Table &atoms = table();
+  {
+    std::shared_lock lock {atoms.mutex};
+    auto found = atoms.atoms.find(id);
+
+    if (found != atoms.atoms.end()) {
+      m_interned = cached = &*found;
+      return;
+    }
+  }
+
+  std::unique_lock lock {atoms.mutex};
+  auto found = atoms.atoms.find(id);
+
+  if (found == atoms.atoms.end()) {
+    if (atoms.atoms.size() >= atoms.limit) {
+      throw AtomException {
+        fmt("Limit of {} interned identifiers reached by '{}'", atoms.limit, id),
+      };
+    }
+    found = atoms.atoms.emplace(id).first;
+  }
+
+  m_interned = cached = &*found;
+}
+
+Atom Atom::find(std::string_view id) {
+  if (id.empty()) {
+    return {};
+  }
+
+  const Interned *cached = cache[Hash {}(id) % CACHE_SIZE];
+
+  if (cached && cached->id == id) {
+    return Atom {cached};
+  }
+
+  Table &atoms = table();
+  std::shared_lock lock {atoms.mutex};
+  auto found = atoms.atoms.find(id);
+  return found != atoms.atoms.end() ? Atom {&*found} : Atom {};
+}
+
+size_t Atom::count() {
+  Table &atoms = table();
+  std::shared_lock lock {atoms.mutex};
+  return atoms.atoms.size();
+}
+
+void Atom::set_limit(size_t limit) {
+  Table &atoms = table();
+  std::unique_lock lock {atoms.mutex};
+  atoms.limit = limit;
+}
+
+size_t Atom::limit() {
+  Table &atoms = table();
+  std::shared_lock lock {atoms.mutex};
+  return atoms.limit;
+}
+
+}  // namespace sdata
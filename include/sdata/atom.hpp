@@ -0,0 +1,91 @@
+#ifndef SDATA_ATOM_HPP
+#define SDATA_ATOM_HPP
+
+#include "misc/exception.hpp"
+#include "misc/fmt.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sdata {
+
+class AtomException : public Exception {
+public:
+  AtomException(std::string_view description) :
+    Exception(fmt("[sdata::AtomException raised]: {}", description)) {}
+};
+
+// Interned identifier. The characters of each distinct identifier are stored once in a global
+// table shared by the threads, an atom is a pointer to them and compares as an integer.
+// The table never shrinks, its atoms stay valid until the program exits: every distinct
+// identifier of every parsed source is kept. Programs parsing untrusted sources bound the
+// growth with Atom::set_limit(), the identifiers already interned stay available
+class Atom {
+public:
+  /// Empty identifier
+  constexpr Atom() = default;
+
+  /// Intern the identifier, its characters are copied only the first time
+  explicit Atom(std::string_view id);
+
+  /// Atom of an already interned identifier, the empty atom otherwise
+  static Atom find(std::string_view id);
+
+  /// Interned identifiers count
+  static size_t count();
+
+  /// Maximum count of interned identifiers, interning a new identifier past it throws an
+  /// AtomException. Unbounded by default, a limit of count() stops the table growth
+  static void set_limit(size_t limit);
+  static size_t limit();
+
+  inline std::string_view view() const {
+    return m_interned ? std::string_view {m_interned->id} : std::string_view {};
+  }
+
+  /// Count of the nodes renamed or assigned to the identifier so far. Sequence indexes record it
+  /// with each indexed identifier: while unchanged, no member took the identifier since
+  inline uint32_t renames() const {
+    return (m_interned ? m_interned->renames : anonymous_renames).load(std::memory_order_relaxed);
+  }
+
+  /// Record a node renamed to the identifier
+  inline void count_rename() const {
+    (m_interned ? m_interned->renames : anonymous_renames).fetch_add(1, std::memory_order_relaxed);
+  }
+
+  inline operator std::string_view() const {
+    return view();
+  }
+
+  inline bool empty() const {
+    return !m_interned;
+  }
+
+  /// Mixed address of the interned characters, its low bits are usable as a table index
+  inline size_t hash() const {
+    return reinterpret_cast<uintptr_t>(m_interned) * 0x9e3779b97f4a7c15 >> 32;
+  }
+
+  inline bool operator==(const Atom &other) const = default;
+
+  /// Characters of an identifier in the table
+  struct Interned {
+    explicit Interned(std::string_view id) : id(id) {}
+
+    std::string id;
+    mutable std::atomic<uint32_t> renames = 0;
+  };
+
+private:
+  explicit Atom(const Interned *interned) : m_interned(interned) {}
+
+  inline static std::atomic<uint32_t> anonymous_renames = 0;
+
+  const Interned *m_interned = nullptr;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,433 @@
+#ifndef SDATA_CONSTANT_HPP
+#define SDATA_CONSTANT_HPP
+
+#include "node.hpp"
+#include "skimmer.hpp"
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace sdata {
+
+// String literal usable as a template argument
+template<size_t N>
+struct Literal {
+  constexpr Literal(const char (&literal)[N]) {
+    std::copy_n(literal, N, data);
+  }
+
+  constexpr std::string_view view() const {
+    return {data, N - 1};
+  }
+
+  char data[N];
+};
+
+// Entry of a constant tree. The children of a container are contiguous entries, the identifiers
+// and the decoded strings are ranges of a shared character buffer
+struct ConstantEntry {
+  Type type = NIL;
+  size_t id = 0, id_size = 0;
+  int integer = 0;
+  float floating = 0;
+  bool boolean = false;
+
+  /// Children of a container or characters of a string
+  size_t first = 0, size = 0;
+};
+
+// Parser running in constant evaluations, it follows the grammar of the Parser without the
+// regex-driven scanner. Syntax errors throw, which fails the compilation of a constant evaluation.
+// The root entry is the last one.
+class ConstantParser {
+public:
+  constexpr static size_t MAX_DEPTH = 256;
+
+  constexpr explicit ConstantParser(std::string_view source) : m_source(source) {}
+
+  constexpr void parse() {
+    ConstantEntry root {};
+
+    if (skip_ignored() < m_source.size()) {
+      root = parse_node();
+    }
+
+    if (skip_ignored() < m_source.size()) {
+      error("Unexpected content after the root node");
+    }
+
+    entries.push_back(root);
+  }
+
+  std::vector<ConstantEntry> entries {};
+  std::vector<char> characters {};
+
+private:
+  constexpr ConstantEntry parse_node() {
+    ConstantEntry node {};
+
+    // Anonymous nodes start with their sequence
+    if (!accept('{')) {
+      std::string_view id = parse_id();
+      node.id = characters.size();
+      node.id_size = id.size();
+      characters.insert(characters.end(), id.begin(), id.end());
+
+      skip_ignored();
+
+      if (accept(':')) {
+        parse_value(node);
+        return node;
+      }
+
+      expect('{');
+    }
+
+    enter();
+    std::vector<ConstantEntry> members {};
+
+    do {
+      skip_ignored();
+      members.push_back(parse_node());
+      skip_ignored();
+    } while (accept(','));
+
+    expect('}');
+    leave();
+
+    node.type = SEQUENCE;
+    place(node, members);
+    return node;
+  }
+
+  constexpr void parse_value(ConstantEntry &value) {
+    if (skip_ignored() >= m_source.size()) {
+      error("Expected a value");
+    }
+
+    char c = m_source[m_n];
+
+    if (c == '[') {
+      m_n++;
+      enter();
+      std::vector<ConstantEntry> items {};
+
+      do {
+        items.emplace_back();
+        parse_value(items.back());
+        skip_ignored();
+      } while (accept(','));
+
+      expect(']');
+      leave();
+
+      value.type = ARRAY;
+      place(value, items);
+    } else if (c == '\'' || c == '"') {
+      size_t end = closing_quote(m_source, m_n);
+
+      if (end == std::string_view::npos) {
+        error("Unterminated string");
+      }
+
+      std::string escaped = unescape(m_source.substr(m_n + 1, end - m_n - 1));
+      value.type = STRING;
+      value.first = characters.size();
+      value.size = escaped.size();
+      characters.insert(characters.end(), escaped.begin(), escaped.end());
+      m_n = end + 1;
+    } else {
+      parse_word(value);
+    }
+  }
+
+  constexpr void parse_word(ConstantEntry &value) {
+    size_t begin = m_n;
+
+    while (m_n < m_source.size() && !Skimmer::is_delimiter(m_source[m_n])) {
+      m_n++;
+    }
+
+    std::string_view word = m_source.substr(begin, m_n - begin);
+
+    if (word == "nil") {
+      value.type = NIL;
+    } else if (word == "true" || word == "false") {
+      value.type = BOOL;
+      value.boolean = word == "true";
+    } else {
+      parse_number(word, value);
+    }
+  }
+
+  /// Numbers of Token::INT and Token::FLOAT without a leading '+'. Floats are the quotient of
+  /// their digits and a power of ten rounded once in double then narrowed, exact up to 15 digits
+  constexpr void parse_number(std::string_view word, ConstantEntry &value) {
+    bool negative = !word.empty() && word[0] == '-';
+    size_t n = negative;
+    double number = 0, scale = 1;
+
+    auto digits = [&](bool is_fraction) {
+      size_t begin = n;
+
+      for (; n < word.size() && word[n] >= '0' && word[n] <= '9'; n++) {
+        number = number * 10 + (word[n] - '0');
+
+        if (is_fraction) {
+          scale *= 10;
+        }
+      }
+
+      if (n == begin) {
+        error("Expected a value");
+      }
+    };
+
+    digits(false);
+
+    if (n == word.size()) {
+      if (number > std::numeric_limits<int>::max() + static_cast<double>(negative)) {
+        error("Integer out of range");
+      }
+
+      value.type = INT;
+      value.integer = static_cast<int>(negative ? -number : number);
+      return;
+    }
+
+    if (word[n++] != '.') {
+      error("Expected a value");
+    }
+
+    digits(true);
+
+    if (n < word.size() && word[n] == 'f') {
+      n++;
+    }
+
+    if (n != word.size()) {
+      error("Expected a value");
+    }
+
+    number /= scale;
+    value.type = FLOAT;
+    value.floating = static_cast<float>(negative ? -number : number);
+  }
+
+  constexpr std::string_view parse_id() {
+    size_t begin = m_n;
+
+    if (m_n >= m_source.size() || !(identifier_character(m_source[m_n]) & IDENTIFIER_HEAD)) {
+      error("Expected an identifier");
+    }
+
+    while (m_n < m_source.size() && identifier_character(m_source[m_n]) & IDENTIFIER_TAIL) {
+      m_n++;
+    }
+
+    return m_source.substr(begin, m_n - begin);
+  }
+
+  /// Move the children after the entries, they are contiguous
+  constexpr void place(ConstantEntry &container, const std::vector<ConstantEntry> &children) {
+    container.first = entries.size();
+    container.size = children.size();
+    entries.insert(entries.end(), children.begin(), children.end());
+  }
+
+  constexpr size_t skip_ignored() {
+    while (m_n < m_source.size()) {
+      if (m_source[m_n] == '#') {
+        if ((m_n = m_source.find('#', m_n + 1)) == std::string_view::npos) {
+          error("Unterminated comment");
+        }
+        m_n++;
+      } else if (Skimmer::is_blank(m_source[m_n])) {
+        m_n++;
+      } else {
+        break;
+      }
+    }
+
+    return m_n;
+  }
+
+  constexpr bool accept(char c) {
+    if (m_n < m_source.size() && m_source[m_n] == c) {
+      m_n++;
+      return true;
+    }
+    return false;
+  }
+
+  constexpr void expect(char c) {
+    if (!accept(c)) {
+      error(c == '}' ? "Expected '}'" : c == ']' ? "Expected ']'" : "Expected '{' or ':'");
+    }
+  }
+
+  constexpr void enter() {
+    if (++m_depth > MAX_DEPTH) {
+      error("Maximum nesting depth exceeded");
+    }
+  }
+
+  constexpr void leave() {
+    m_depth--;
+  }
+
+  /// Not a constant expression, reached by a constant evaluation it fails the compilation
+  [[noreturn]] static void error(const char *description) {
+    throw Exception {fmt("[sdata::Exception raised] constant parsing failed: {}", description)};
+  }
+
+  std::string_view m_source;
+  size_t m_n = 0;
+  size_t m_depth = 0;
+};
+
+// Read-only node of a constant tree
+class ConstantNode {
+public:
+  constexpr ConstantNode(const ConstantEntry *entries, const char *characters, size_t index) :
+    m_entries(entries),
+    m_characters(characters),
+    m_index(index) {}
+
+  constexpr std::string_view id() const {
+    return {m_characters + entry().id, entry().id_size};
+  }
+
+  constexpr Type type() const {
+    return entry().type;
+  }
+
+  constexpr bool is_anonymous() const {
+    return entry().id_size == 0;
+  }
+
+  /// Children count of a container
+  constexpr size_t size() const {
+    return type() == ARRAY || type() == SEQUENCE ? entry().size : 0;
+  }
+
+  /// Access the n-th member or item of the container
+  constexpr ConstantNode operator[](size_t n) const {
+    if (n >= size()) {
+      throw Exception {"Constant node child out of range"};
+    }
+    return {m_entries, m_characters, entry().first + n};
+  }
+
+  /// Access member by id in the sequence
+  constexpr ConstantNode at(std::string_view id) const {
+    for (size_t n = 0; type() == SEQUENCE && n < size(); n++) {
+      if ((*this)[n].id() == id) {
+        return (*this)[n];
+      }
+    }
+    throw Exception {"Member not found in constant node sequence"};
+  }
+
+  /// Get the int, float, bool or std::string_view value
+  template<typename T>
+  constexpr T get() const {
+    if (type() != Traits<T>::index) {
+      throw Exception {"Constant node alternative not available"};
+    }
+
+    if constexpr (std::same_as<T, std::string_view>) {
+      return {m_characters + entry().first, entry().size};
+    } else if constexpr (std::same_as<T, bool>) {
+      return entry().boolean;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      return entry().floating;
+    } else {
+      return entry().integer;
+    }
+  }
+
+  /// Runtime node tree borrowing the constant identifiers and strings
+  Node node() const {
+    return Node::trusted(id(), variant());
+  }
+
+  operator Node() const {
+    return node();
+  }
+
+private:
+  constexpr const ConstantEntry &entry() const {
+    return m_entries[m_index];
+  }
+
+  Variant variant() const {
+    switch (type()) {
+      case ARRAY: {
+        Array array {};
+        array.reserve(size());
+
+        for (size_t n = 0; n < size(); n++) {
+          array.push_back((*this)[n].variant());
+        }
+        return array;
+      }
+
+      case SEQUENCE: {
+        Sequence sequence {};
+        sequence.reserve(size());
+
+        for (size_t n = 0; n < size(); n++) {
+          sequence.push_back((*this)[n].node());
+        }
+        return sequence;
+      }
+
+      case FLOAT: return entry().floating;
+      case INT: return entry().integer;
+      case BOOL: return entry().boolean;
+      case STRING: return String::borrow(get<std::string_view>());
+      default: return nullptr;
+    }
+  }
+
+  const ConstantEntry *m_entries;
+  const char *m_characters;
+  size_t m_index;
+};
+
+// Constant tree of a literal, parsed once at compile time into static read-only arrays
+template<Literal S>
+struct ConstantTree {
+  constexpr static auto SIZES = [] {
+    ConstantParser parser {S.view()};
+    parser.parse();
+    return std::array<size_t, 2> {parser.entries.size(), parser.characters.size()};
+  }();
+
+  constexpr static auto ENTRIES = [] {
+    ConstantParser parser {S.view()};
+    parser.parse();
+
+    std::array<ConstantEntry, SIZES[0]> entries {};
+    std::copy(parser.entries.begin(), parser.entries.end(), entries.begin());
+    return entries;
+  }();
+
+  constexpr static auto CHARACTERS = [] {
+    ConstantParser parser {S.view()};
+    parser.parse();
+
+    std::array<char, SIZES[1] + 1> characters {};
+    std::copy(parser.characters.begin(), parser.characters.end(), characters.begin());
+    return characters;
+  }();
+
+  constexpr static ConstantNode root() {
+    return {ENTRIES.data(), CHARACTERS.data(), SIZES[0] - 1};
+  }
+};
+
+}  // namespace sdata
+
+#endif
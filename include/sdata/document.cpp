@@ -0,0 +1,243 @@
+#include "document.hpp"
+
+namespace sdata {
+
+static std::string member_path(const std::string &path, const Node &member, size_t index) {
+  if (member.is_anonymous()) {
+    return fmt("{}[{}]", path, index);
+  }
+
+  return path.empty() ? std::string {member.id()} : fmt("{}.{}", path, member.id());
+}
+
+static std::string item_path(const std::string &path, size_t index) {
+  return fmt("{}[{}]", path, index);
+}
+
+/// Span relative to the parent beginning at base, the nesting is bounded by the parser max depth
+static DocumentSpan relative(const SourceSpan &span, size_t base) {
+  DocumentSpan relative {
+    span.begin - base,
+    span.end - span.begin,
+    span.value_begin - span.begin,
+    span.value_end - span.value_begin,
+  };
+
+  relative.children.reserve(span.children.size());
+
+  for (const SourceSpan &child : span.children) {
+    relative.children.push_back(sdata::relative(child, span.begin));
+  }
+  return relative;
+}
+
+static SourceSpan absolute(const DocumentSpan &span, size_t base) {
+  size_t begin = base + span.offset;
+  SourceSpan absolute {
+    begin,
+    begin + span.size,
+    begin + span.value_offset,
+    begin + span.value_offset + span.value_size,
+  };
+
+  absolute.children.reserve(span.children.size());
+
+  for (const DocumentSpan &child : span.children) {
+    absolute.children.push_back(sdata::absolute(child, begin));
+  }
+  return absolute;
+}
+
+Document::Document(std::string source, ParserOptions options) :
+  m_source(std::move(source)),
+  m_options(options),
+  m_root(""),
+  m_span() {
+  // Borrowed nodes would reference the edited source
+  m_options.borrow = false;
+  m_options.spans = true;
+
+  Parser parser {m_source, m_options};
+  m_root = parser.parse();
+  m_span = relative(parser.span(), 0);
+}
+
+SourceSpan Document::span() const {
+  return absolute(m_span, 0);
+}
+
+std::vector<std::string> Document::edit(size_t begin, size_t end, std::string_view text) {
+  if (begin > end || end > m_source.size()) {
+    throw DocumentException {
+      fmt("Edit range [{}, {}) out of the source of size {}", begin, end, m_source.size()),
+    };
+  }
+
+  ptrdiff_t delta = static_cast<ptrdiff_t>(text.size()) - static_cast<ptrdiff_t>(end - begin);
+  std::vector<Region> regions = find_regions(begin, end);
+  std::vector<std::string> changed {};
+
+  // Edited in place, only the replaced range is kept to restore the source on errors
+  std::string replaced = m_source.substr(begin, end - begin);
+  m_source.replace(begin, end - begin, text);
+
+  try {
+    // Widen the region until it parses on its own, the root always does or throws
+    while (!reparse(regions, delta, changed)) {
+      regions.pop_back();
+    }
+  } catch (...) {
+    m_source.replace(begin, text.size(), replaced);
+    throw;
+  }
+
+  return changed;
+}
+
+std::vector<Document::Region> Document::find_regions(size_t begin, size_t end) {
+  std::vector<Region> regions {{nullptr, 0, &m_span, m_span.offset, ""}};
+  Variant *variant = &m_root;
+
+  while (variant->is<Sequence>() || variant->is<Array>()) {
+    auto &children = regions.back().span->children;
+    size_t base = regions.back().begin;
+
+    // Last child starting before the edit
+    auto child = std::partition_point(children.begin(), children.end(), [&](const auto &span) {
+      return base + span.offset <= begin;
+    });
+
+    if (child == children.begin() || base + (--child)->offset + child->size < end) {
+      break;
+    }
+
+    size_t index = child - children.begin();
+    size_t child_begin = base + child->offset;
+    std::string path = regions.back().path;
+
+    if (auto *sequence = variant->get_ptr<Sequence>()) {
+      path = member_path(path, (*sequence)[index], index);
+      regions.push_back({variant, index, &*child, child_begin, std::move(path)});
+      variant = &(*sequence)[index];
+    } else {
+      path = item_path(path, index);
+      regions.push_back({variant, index, &*child, child_begin, std::move(path)});
+      variant = &variant->get<Array>()[index];
+    }
+  }
+
+  return regions;
+}
+
+bool Document::reparse(
+  std::vector<Region> &regions,
+  ptrdiff_t delta,
+  std::vector<std::string> &changed) {
+  Region &region = regions.back();
+
+  if (!region.parent) {
+    Parser parser {m_source, m_options};
+    Node root = parser.parse();
+
+    if (m_root.id() != root.id()) {
+      changed.push_back(region.path);
+    } else {
+      diff(m_root, root, region.path, changed);
+    }
+
+    m_root = std::move(root);
+    m_span = relative(parser.span(), 0);
+    return true;
+  }
+
+  Parser parser {m_source, region.begin, region.begin + region.span->size + delta, m_options};
+
+  try {
+    if (auto *sequence = region.parent->get_ptr<Sequence>()) {
+      Sequence members = parser.parse_members();
+
+      if (members.size() != 1) {
+        return false;
+      }
+
+      Node &previous = (*sequence)[region.index];
+
+      if (previous.id() != members[0].id()) {
+        changed.push_back(region.path);
+        changed.push_back(member_path(regions[regions.size() - 2].path, members[0], region.index));
+      } else {
+        diff(previous, members[0], region.path, changed);
+      }
+
+      previous = std::move(members[0]);
+    } else {
+      Array items = parser.parse_items();
+
+      if (items.size() != 1) {
+        return false;
+      }
+
+      Variant &previous = region.parent->get<Array>()[region.index];
+      diff(previous, items[0], region.path, changed);
+      previous = std::move(items[0]);
+    }
+  } catch (const Exception &) {
+    return false;
+  }
+
+  *region.span = relative(parser.span(), regions[regions.size() - 2].begin);
+
+  // Resize the enclosing spans and move their following children, the nested spans are relative
+  for (size_t i = regions.size() - 1; i > 0; i--) {
+    DocumentSpan &parent = *regions[i - 1].span;
+    parent.size += delta;
+    parent.value_size += delta;
+
+    for (size_t j = regions[i].index + 1; j < parent.children.size(); j++) {
+      parent.children[j].offset += delta;
+    }
+  }
+
+  return true;
+}
+
+void Document::diff(
+  const Variant &previous,
+  const Variant &current,
+  const std::string &path,
+  std::vector<std::string> &changed) {
+  if (previous == current) {
+    return;
+  }
+
+  // Descend while the structure matches to report the innermost changes
+  if (previous.is<Sequence>() && current.is<Sequence>()) {
+    const Sequence &p = previous.get<Sequence>();
+    const Sequence &c = current.get<Sequence>();
+
+    auto same_id = [](const Node &a, const Node &b) {
+      return a.id() == b.id();
+    };
+
+    if (p.size() == c.size() && std::equal(p.begin(), p.end(), c.begin(), same_id)) {
+      for (size_t i = 0; i < c.size(); i++) {
+        diff(p[i], c[i], member_path(path, c[i], i), changed);
+      }
+      return;
+    }
+  } else if (previous.is<Array>() && current.is<Array>()) {
+    const Array &p = previous.get<Array>();
+    const Array &c = current.get<Array>();
+
+    if (p.size() == c.size()) {
+      for (size_t i = 0; i < c.size(); i++) {
+        diff(p[i], c[i], item_path(path, i), changed);
+      }
+      return;
+    }
+  }
+
+  changed.push_back(path);
+}
+
+}  // namespace sdata
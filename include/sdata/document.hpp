@@ -0,0 +1,90 @@
+#ifndef SDATA_DOCUMENT_HPP
+#define SDATA_DOCUMENT_HPP
+
+#include "parser.hpp"
+#include <string>
+
+namespace sdata {
+
+class DocumentException : public Exception {
+public:
+  DocumentException(std::string_view description) :
+    Exception(fmt("[sdata::DocumentException raised]: {}", description)) {}
+};
+
+// Span of a document node relative to its parent, an edit only moves the following siblings
+struct DocumentSpan {
+  /// Distance from the parent begin, from the source begin for the root
+  size_t offset = 0;
+  size_t size = 0;
+
+  /// Value distance from the node begin, brackets included for sequences and arrays
+  size_t value_offset = 0;
+  size_t value_size = 0;
+
+  std::vector<DocumentSpan> children = {};
+
+  bool operator==(const DocumentSpan &) const = default;
+};
+
+// Parsed source keeping the span of every node. An edit only reparses the smallest member or
+// array item enclosing the edited range, the untouched subtrees are kept. The spans are relative
+// to their parent so only the sizes along the enclosing path and the following siblings offsets
+// are adjusted, the source is edited in place. The whole source is reparsed when no enclosing
+// member parses on its own.
+class Document {
+public:
+  explicit Document(std::string source, ParserOptions options = {});
+
+  inline const Node &root() const {
+    return m_root;
+  }
+
+  inline std::string_view source() const {
+    return m_source;
+  }
+
+  /// Absolute spans, rebuilt from the relative ones
+  SourceSpan span() const;
+
+  inline const DocumentSpan &relative_span() const {
+    return m_span;
+  }
+
+  /// Replace the [begin, end) range of the source with the text and reparse the edited region.
+  /// Returns the paths of the changed nodes, the document is left unchanged on parsing errors
+  std::vector<std::string> edit(size_t begin, size_t end, std::string_view text);
+
+private:
+  // Member or array item enclosing the edited range
+  struct Region {
+    Variant *parent;
+    size_t index;
+    DocumentSpan *span;
+
+    /// Absolute begin of the span
+    size_t begin;
+    std::string path;
+  };
+
+  std::vector<Region> find_regions(size_t begin, size_t end);
+  bool reparse(
+    std::vector<Region> &regions,
+    ptrdiff_t delta,
+    std::vector<std::string> &changed);
+
+  static void diff(
+    const Variant &previous,
+    const Variant &current,
+    const std::string &path,
+    std::vector<std::string> &changed);
+
+  std::string m_source;
+  ParserOptions m_options;
+  Node m_root;
+  DocumentSpan m_span;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,151 @@
+#include "extractor.hpp"
+
+namespace sdata {
+
+Extractor::Extractor(std::string_view source, const std::vector<std::string_view> &paths) :
+  m_source(source),
+  m_skimmer(source),
+  m_selection({"", false, {}}) {
+  for (std::string_view path : paths) {
+    Selection *selection = &m_selection;
+
+    while (!selection->whole) {
+      std::string_view id = path.substr(0, path.find('.'));
+
+      auto child = std::find_if(
+        selection->children.begin(), selection->children.end(), [&](const Selection &s) {
+          return s.id == id;
+        });
+
+      if (child == selection->children.end()) {
+        selection->children.push_back({id, false, {}});
+        child = selection->children.end() - 1;
+      }
+
+      selection = &*child;
+
+      if (id.size() == path.size()) {
+        // A whole member includes the deeper selections
+        selection->whole = true;
+        selection->children.clear();
+      } else {
+        path.remove_prefix(id.size() + 1);
+      }
+    }
+  }
+}
+
+Node Extractor::extract() {
+  size_t n = m_skimmer.skip_ignored(0);
+  Node root {""};
+
+  try {
+    // Named root, the identifier is validated by the node
+    if (n < m_source.size() && m_source[n] != '{') {
+      size_t id_end = m_skimmer.skip_word(n);
+
+      if (id_end != Skimmer::npos) {
+        root = Node {m_source.substr(n, id_end - n)};
+        n = m_skimmer.skip_ignored(id_end);
+      }
+    }
+
+    if (n < m_source.size() && m_source[n] == '{' &&
+        extract_sequence(n, m_selection, root, true) != Skimmer::npos) {
+      return root;
+    }
+  } catch (const Exception &) {
+  }
+
+  root = Parser(m_source).parse();
+  prune(root, m_selection);
+  return root;
+}
+
+size_t Extractor::extract_sequence(size_t n, const Selection &selection, Node &node, bool root) {
+  std::vector<bool> found(selection.children.size(), false);
+  size_t remaining = found.size();
+  node = Sequence {};
+
+  do {
+    size_t begin = m_skimmer.skip_ignored(n + 1);
+    size_t end = m_skimmer.skip_node(begin);
+
+    if (end == Skimmer::npos) {
+      return Skimmer::npos;
+    }
+
+    // Anonymous members can't be selected
+    if (m_source[begin] != '{' && remaining > 0) {
+      std::string_view id = m_source.substr(begin, m_skimmer.skip_word(begin) - begin);
+      size_t i = 0;
+
+      while (i < found.size() && (found[i] || selection.children[i].id != id)) {
+        i++;
+      }
+
+      if (i < found.size()) {
+        const Selection &child = selection.children[i];
+        size_t value = m_skimmer.skip_ignored(begin + id.size());
+        found[i] = true;
+        remaining--;
+
+        if (child.whole) {
+          node.get<Sequence>().push_back(*Parser(m_source, begin, end).parse_next());
+        } else if (m_source[value] == '{') {
+          Node &member = node.get<Sequence>().emplace_back(id);
+          end = extract_sequence(value, child, member, false);
+        }
+      }
+    }
+
+    // The rest of the root is never skimmed once every path is matched
+    if (root && remaining == 0) {
+      return end;
+    }
+
+    if (end == Skimmer::npos || (n = m_skimmer.skip_ignored(end)) >= m_source.size()) {
+      return Skimmer::npos;
+    }
+  } while (m_source[n] == ',');
+
+  return m_source[n] == '}' ? n + 1 : Skimmer::npos;
+}
+
+void Extractor::prune(Node &node, const Selection &selection) const {
+  Sequence *sequence = node.get_ptr<Sequence>();
+  std::vector<bool> found(selection.children.size(), false);
+  Sequence pruned {};
+
+  if (!sequence) {
+    node = Sequence {};
+    return;
+  }
+
+  for (Node &member : *sequence) {
+    size_t i = 0;
+
+    while (i < found.size() && (found[i] || selection.children[i].id != member.id())) {
+      i++;
+    }
+
+    if (i == found.size()) {
+      continue;
+    }
+
+    found[i] = true;
+
+    if (!selection.children[i].whole) {
+      if (!member.is<Sequence>()) {
+        continue;
+      }
+      prune(member, selection.children[i]);
+    }
+
+    pruned.push_back(std::move(member));
+  }
+
+  node = std::move(pruned);
+}
+
+}  // namespace sdata
@@ -0,0 +1,39 @@
+#ifndef SDATA_EXTRACTOR_HPP
+#define SDATA_EXTRACTOR_HPP
+
+#include "parser.hpp"
+#include "skimmer.hpp"
+
+namespace sdata {
+
+// Extracts the members on the requested paths of the root sequence into a pruned node tree.
+// The members off the paths are skipped by the skimmer without tokenizing, only the matched
+// members are parsed and the scan stops once every path is matched. As with Node::at(), only the
+// first member with a given id is followed. A source the skimmer can't follow is fully parsed
+// then pruned, so the reported errors match Parser::parse().
+class Extractor {
+public:
+  /// Paths of member ids separated by dots, relative to the root node
+  Extractor(std::string_view source, const std::vector<std::string_view> &paths);
+
+  Node extract();
+
+private:
+  struct Selection {
+    std::string_view id;
+    bool whole;
+    std::vector<Selection> children;
+  };
+
+  /// Extract the selected members of the sequence opened at n, returns the position following it
+  size_t extract_sequence(size_t n, const Selection &selection, Node &node, bool root);
+  void prune(Node &node, const Selection &selection) const;
+
+  std::string_view m_source;
+  Skimmer m_skimmer;
+  Selection m_selection;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,195 @@
+#include "frozen.hpp"
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace sdata {
+
+std::optional<FrozenNode> FrozenNode::search(std::string_view id) const {
+  if (type() != SEQUENCE) {
+    return std::nullopt;
+  }
+
+  for (size_t n = entry().first; n < entry().first + entry().size; n++) {
+    const FrozenEntry &member = m_entries[n];
+
+    if (
+      member.id_size == id.size() &&
+      std::memcmp(m_characters + member.id, id.data(), id.size()) == 0) {
+      return FrozenNode {m_entries, m_characters, n};
+    }
+  }
+
+  return std::nullopt;
+}
+
+FrozenNode FrozenNode::at(std::string_view id) const {
+  if (auto member = search(id)) {
+    return *member;
+  }
+  throw FrozenException {fmt("Member named '{}' not found in frozen node '{}'", id, this->id())};
+}
+
+Node FrozenNode::node() const {
+  return Node::trusted(id(), variant());
+}
+
+Variant FrozenNode::variant() const {
+  switch (type()) {
+    case ARRAY: {
+      Array items {};
+      items.reserve(size());
+
+      for (FrozenNode item : *this) {
+        items.push_back(item.variant());
+      }
+
+      // Packed as the parser does
+      size_t size = items.size();
+      Variant array {std::move(items)};
+
+      if (size >= PackedArray::PACK_THRESHOLD) {
+        array.pack();
+      }
+      return array;
+    }
+
+    case SEQUENCE: {
+      Sequence sequence {};
+      sequence.reserve(size());
+
+      for (FrozenNode member : *this) {
+        sequence.push_back(member.node());
+      }
+      return sequence;
+    }
+
+    case FLOAT: return entry().floating;
+    case INT: return entry().integer;
+    case BOOL: return entry().boolean;
+    case STRING: return String {get<std::string_view>()};
+    default: return nullptr;
+  }
+}
+
+// Breadth-first layout of a node tree, the entries vector is the queue of the containers
+class Freezer {
+public:
+  explicit Freezer(const Node &root) {
+    append(root, root.atom());
+
+    for (size_t n = 0; n < entries.size(); n++) {
+      if (m_containers[n]) {
+        expand(n, *m_containers[n]);
+      }
+    }
+  }
+
+  std::vector<FrozenEntry> entries {};
+  std::string characters {};
+
+private:
+  void expand(size_t n, const Variant &container) {
+    uint32_t first = offset(entries.size());
+
+    if (const Sequence *sequence = container.get_ptr<Sequence>()) {
+      for (const Node &member : *sequence) {
+        append(member, member.atom());
+      }
+    } else if (const PackedArray *packed = container.packed()) {
+      packed->visit([this]<typename T>(std::span<const T> items) {
+        for (const T &item : items) {
+          append(Variant {item}, {});
+        }
+      });
+    } else {
+      for (const Variant &item : container.get<Array>()) {
+        append(item, {});
+      }
+    }
+
+    entries[n].first = first;
+    entries[n].size = offset(entries.size()) - first;
+  }
+
+  /// Append the entry of the value, the containers are expanded when the queue reaches them
+  void append(const Variant &value, Atom id) {
+    FrozenEntry entry {};
+    entry.type = value.type();
+    const Variant *container = nullptr;
+
+    if (!id.empty()) {
+      auto [interned, is_new] = m_ids.try_emplace(id, offset(characters.size()));
+
+      if (is_new) {
+        characters += id.view();
+      }
+
+      entry.id = interned->second;
+      entry.id_size = offset(id.view().size());
+    }
+
+    switch (value.type()) {
+      case ARRAY:
+      case SEQUENCE: container = &value; break;
+      case FLOAT: entry.floating = value.get<float>(); break;
+      case INT: entry.integer = value.get<int>(); break;
+      case BOOL: entry.boolean = value.get<bool>(); break;
+      case STRING: {
+        std::string_view string = value.get<String>().view();
+        entry.first = offset(characters.size());
+        entry.size = offset(string.size());
+        characters += string;
+        break;
+      }
+      default: break;
+    }
+
+    entries.push_back(entry);
+    m_containers.push_back(container);
+  }
+
+  static uint32_t offset(size_t offset) {
+    if (offset > std::numeric_limits<uint32_t>::max()) {
+      throw FrozenException {"Node tree too large to be frozen"};
+    }
+    return static_cast<uint32_t>(offset);
+  }
+
+  struct AtomHash {
+    inline size_t operator()(Atom atom) const {
+      return atom.hash();
+    }
+  };
+
+  /// Source container of each entry, nullptr for the scalars
+  std::vector<const Variant *> m_containers {};
+
+  /// Offset of each identifier in the string pool
+  std::unordered_map<Atom, uint32_t, AtomHash> m_ids {};
+};
+
+Frozen::Frozen(const Node &node) {
+  Freezer freezer {node};
+
+  m_entry_count = freezer.entries.size();
+  m_character_count = freezer.characters.size();
+  m_block = std::make_unique_for_overwrite<std::byte[]>(bytes());
+
+  std::memcpy(m_block.get(), freezer.entries.data(), m_entry_count * sizeof(FrozenEntry));
+  std::memcpy(
+    m_block.get() + m_entry_count * sizeof(FrozenEntry),
+    freezer.characters.data(),
+    m_character_count);
+}
+
+Frozen::Frozen(const Frozen &other) :
+  m_block(std::make_unique_for_overwrite<std::byte[]>(other.bytes())),
+  m_entry_count(other.m_entry_count),
+  m_character_count(other.m_character_count) {
+  if (other.m_block) {
+    std::memcpy(m_block.get(), other.m_block.get(), bytes());
+  }
+}
+
+}  // namespace sdata
@@ -0,0 +1,222 @@
+#ifndef SDATA_FROZEN_HPP
+#define SDATA_FROZEN_HPP
+
+#include "node.hpp"
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace sdata {
+
+class FrozenException : public Exception {
+public:
+  FrozenException(std::string_view description) :
+    Exception(fmt("[sdata::FrozenException raised]: {}", description)) {}
+};
+
+// Entry of a frozen tree. The children of a container are contiguous entries, the identifiers and
+// the decoded strings are ranges of the string pool
+struct FrozenEntry {
+  /// Identifier in the string pool
+  uint32_t id = 0, id_size = 0;
+
+  /// Children of a container or characters of a string in the string pool
+  uint32_t first = 0, size = 0;
+
+  union {
+    int integer = 0;
+    float floating;
+    bool boolean;
+  };
+
+  Type type = NIL;
+};
+
+// Read-only node of a frozen tree, valid as long as the tree
+class FrozenNode {
+public:
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = FrozenNode;
+
+    Iterator() = default;
+    Iterator(const FrozenEntry *entries, const char *characters, size_t index) :
+      m_entries(entries),
+      m_characters(characters),
+      m_index(index) {}
+
+    inline FrozenNode operator*() const {
+      return {m_entries, m_characters, m_index};
+    }
+
+    inline Iterator &operator++() {
+      m_index++;
+      return *this;
+    }
+
+    inline Iterator operator++(int) {
+      Iterator previous = *this;
+      m_index++;
+      return previous;
+    }
+
+    inline bool operator==(const Iterator &other) const {
+      return m_index == other.m_index;
+    }
+
+  private:
+    const FrozenEntry *m_entries = nullptr;
+    const char *m_characters = nullptr;
+    size_t m_index = 0;
+  };
+
+  FrozenNode(const FrozenEntry *entries, const char *characters, size_t index) :
+    m_entries(entries),
+    m_characters(characters),
+    m_index(index) {}
+
+  inline std::string_view id() const {
+    return {m_characters + entry().id, entry().id_size};
+  }
+
+  inline Type type() const {
+    return entry().type;
+  }
+
+  /// Does the node contain value of type <T> ?
+  template<typename T>
+  inline bool is() const {
+    return type() == Traits<T>::index;
+  }
+
+  inline bool is_anonymous() const {
+    return entry().id_size == 0;
+  }
+
+  /// Children count of a container
+  inline size_t size() const {
+    return type() == ARRAY || type() == SEQUENCE ? entry().size : 0;
+  }
+
+  /// Access the n-th member or item of the container
+  FrozenNode at(size_t n) const {
+    if (n >= size()) {
+      throw FrozenException {fmt("Child {} out of the frozen container of size {}", n, size())};
+    }
+    return {m_entries, m_characters, entry().first + n};
+  }
+
+  /// Access the n-th member or item of the container
+  inline FrozenNode operator[](size_t n) const {
+    return at(n);
+  }
+
+  /// Search a member by id in the sequence
+  std::optional<FrozenNode> search(std::string_view id) const;
+
+  /// Access member by id in the sequence
+  FrozenNode at(std::string_view id) const;
+
+  /// Get the int, float, bool or string value, strings are viewed in the string pool
+  template<typename T>
+  T get() const {
+    if (type() != Traits<T>::index) {
+      throw FrozenException {
+        fmt("Frozen node '{}' of type <{}> isn't a <{}>",
+            id(),
+            type(),
+            static_cast<Type>(Traits<T>::index)),
+      };
+    }
+
+    if constexpr (Traits<T>::index == STRING) {
+      return T {std::string_view {m_characters + entry().first, entry().size}};
+    } else if constexpr (std::same_as<T, bool>) {
+      return entry().boolean;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      return static_cast<T>(entry().floating);
+    } else {
+      return static_cast<T>(entry().integer);
+    }
+  }
+
+  /// Children of a container
+  inline Iterator begin() const {
+    return {m_entries, m_characters, entry().first};
+  }
+
+  inline Iterator end() const {
+    return {m_entries, m_characters, entry().first + size()};
+  }
+
+  /// Mutable node tree copying the identifiers and strings
+  Node node() const;
+
+  operator Node() const {
+    return node();
+  }
+
+private:
+  inline const FrozenEntry &entry() const {
+    return m_entries[m_index];
+  }
+
+  Variant variant() const;
+
+  const FrozenEntry *m_entries;
+  const char *m_characters;
+  size_t m_index;
+};
+
+// Read-only node tree stored in a single block: the entries in breadth-first order, the root
+// first, followed by the string pool. Each identifier is stored once in the pool
+class Frozen {
+public:
+  explicit Frozen(const Node &node);
+
+  Frozen(const Frozen &other);
+  Frozen(Frozen &&other) noexcept :
+    m_block(std::move(other.m_block)),
+    m_entry_count(std::exchange(other.m_entry_count, 0)),
+    m_character_count(std::exchange(other.m_character_count, 0)) {}
+
+  Frozen &operator=(Frozen other) noexcept {
+    std::swap(m_block, other.m_block);
+    std::swap(m_entry_count, other.m_entry_count);
+    std::swap(m_character_count, other.m_character_count);
+    return *this;
+  }
+
+  inline FrozenNode root() const {
+    return {entries(), characters(), 0};
+  }
+
+  /// Entries count, one per node and array item
+  inline size_t size() const {
+    return m_entry_count;
+  }
+
+  /// Size of the block
+  inline size_t bytes() const {
+    return m_entry_count * sizeof(FrozenEntry) + m_character_count;
+  }
+
+private:
+  inline const FrozenEntry *entries() const {
+    return std::launder(reinterpret_cast<const FrozenEntry *>(m_block.get()));
+  }
+
+  inline const char *characters() const {
+    return reinterpret_cast<const char *>(m_block.get()) + m_entry_count * sizeof(FrozenEntry);
+  }
+
+  std::unique_ptr<std::byte[]> m_block;
+  size_t m_entry_count = 0, m_character_count = 0;
+};
+
+}  // namespace sdata
+
+#endif
@@ -26,7 +26,7 @@ private:
       PATTERN,
       name,
       description,
-      token.source_location.line,
+      token.source_location.line(),
       token.source_location.snippet(),
       token);
   }
@@ -0,0 +1,74 @@
+#ifndef SDATA_DIGITS_HPP
+#define SDATA_DIGITS_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace sdata {
+
+// Digit runs processed 8 bytes at a time in a 64-bit word (SWAR), the words are loaded in the
+// little-endian order, big-endian targets use the bytewise loops only
+constexpr bool SWAR_DIGITS = std::endian::native == std::endian::little;
+
+inline uint64_t load_word(const char *data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/// Check if the 8 bytes of the word are decimal digits
+constexpr bool is_eight_digits(uint64_t word) {
+  return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+      == 0x3333333333333333;
+}
+
+/// Value of the 8 decimal digits of the word
+constexpr uint32_t parse_eight_digits(uint64_t word) {
+  constexpr uint64_t MASK = 0x000000FF000000FF;
+  constexpr uint64_t MUL1 = 100 + (1000000ULL << 32);
+  constexpr uint64_t MUL2 = 1 + (10000ULL << 32);
+
+  word -= 0x3030303030303030;
+  word = (word * 10) + (word >> 8);
+  return static_cast<uint32_t>(((word & MASK) * MUL1 + ((word >> 16) & MASK) * MUL2) >> 32);
+}
+
+/// Position following the decimal digits starting at n
+inline size_t skip_digits(std::string_view source, size_t n) {
+  if constexpr (SWAR_DIGITS) {
+    while (source.size() - n >= 8 && is_eight_digits(load_word(source.data() + n))) {
+      n += 8;
+    }
+  }
+
+  while (n < source.size() && source[n] >= '0' && source[n] <= '9') {
+    n++;
+  }
+
+  return n;
+}
+
+/// Value of the decimal digits, saturated past the 32-bit range
+inline uint64_t parse_digits(std::string_view digits) {
+  constexpr uint64_t SATURATION = uint64_t {1} << 32;
+  uint64_t value = 0;
+  size_t n = 0;
+
+  if constexpr (SWAR_DIGITS) {
+    for (; digits.size() - n >= 8 && value < SATURATION; n += 8) {
+      value = value * 100000000 + parse_eight_digits(load_word(digits.data() + n));
+    }
+  }
+
+  for (; n < digits.size() && value < SATURATION; n++) {
+    value = value * 10 + (digits[n] - '0');
+  }
+
+  return n < digits.size() ? SATURATION : value;
+}
+
+}  // namespace sdata
+
+#endif
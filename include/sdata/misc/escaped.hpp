@@ -1,7 +1,9 @@
 #ifndef SDATA_ESCAPED_HPP
 #define SDATA_ESCAPED_HPP
 
-#include <istream>
+#include <algorithm>
+#include <string>
+#include <string_view>
 
 namespace sdata {
 
@@ -20,16 +22,103 @@ constexpr char escape_sequence(char code) {
   }
 }
 
-struct Escaped {
-  std::istream &stream;
-};
+/// Code of the escape sequence encoding the character in a string quoted with the quote, zero if
+/// the character is written as is
+constexpr char escape_code(char c, char quote) {
+  switch (c) {
+    case '\a': return 'a';
+    case '\b': return 'b';
+    case '\f': return 'f';
+    case '\n': return 'n';
+    case '\r': return 'r';
+    case '\t': return 't';
+    case '\v': return 'v';
+    case '\\': return '\\';
+    default: return c == quote ? quote : 0;
+  }
+}
+
+constexpr bool is_escaped(std::string_view string) {
+  return string.find('\\') != std::string_view::npos;
+}
+
+/// Decode the escape sequences at the end of the string, a trailing backslash is kept as is
+constexpr void unescape(std::string_view escaped, std::string &string) {
+  for (size_t n = 0, escape; n < escaped.size(); n = escape + 2) {
+    escape = std::min(escaped.find('\\', n), escaped.size());
+    string.append(escaped, n, escape - n);
+
+    if (escape + 1 < escaped.size()) {
+      string += escape_sequence(escaped[escape + 1]);
+    } else if (escape < escaped.size()) {
+      string += '\\';
+    }
+  }
+}
+
+/// Decode the escape sequences into an output of escaped.size() characters at least, returns the
+/// decoded size
+constexpr size_t unescape(std::string_view escaped, char *output) {
+  size_t size = 0;
+
+  for (size_t n = 0; n < escaped.size(); n++, size++) {
+    if (escaped[n] == '\\' && n + 1 < escaped.size()) {
+      output[size] = escape_sequence(escaped[++n]);
+    } else {
+      output[size] = escaped[n];
+    }
+  }
+
+  return size;
+}
+
+/// Decode the escape sequences, a trailing backslash is kept as is
+constexpr std::string unescape(std::string_view escaped) {
+  std::string string {};
+  string.reserve(escaped.size());
+  unescape(escaped, string);
+
+  return string;
+}
+
+/// Encode the backslashes, the quote and the control characters at the end of the escaped string
+constexpr void escape(std::string_view string, char quote, std::string &escaped) {
+  size_t begin = 0;
+
+  for (size_t n = 0; n < string.size(); n++) {
+    if (char code = escape_code(string[n], quote)) {
+      escaped.append(string, begin, n - begin);
+      escaped += '\\';
+      escaped += code;
+      begin = n + 1;
+    }
+  }
+
+  escaped.append(string, begin);
+}
+
+/// Encode the backslashes, the quote and the control characters, see unescape()
+constexpr std::string escape(std::string_view string, char quote) {
+  std::string escaped {};
+  escaped.reserve(string.size());
+  escape(string, quote, escaped);
+
+  return escaped;
+}
+
+/// Position of the quote closing the string opened at n, the escaped characters are skipped.
+/// std::string_view::npos if the string is unterminated
+constexpr size_t closing_quote(std::string_view source, size_t n) {
+  const char delimiters[] = {source[n], '\\'};
 
-static std::ostream &operator<<(std::ostream &os, const Escaped &escaped) {
-  for (std::istreambuf_iterator<char> iter {escaped.stream}, end; iter != end; iter++) {
-    os << (*iter != '\\' ? *iter : escape_sequence(*++iter));
+  while ((n = source.find_first_of(std::string_view {delimiters, 2}, n + 1)) != std::string_view::npos) {
+    if (source[n] == delimiters[0]) {
+      return n;
+    }
+    n++;
   }
 
-  return os;
+  return std::string_view::npos;
 }
 
 }  // namespace sdata
@@ -0,0 +1,18 @@
+#ifndef SDATA_HASH_HPP
+#define SDATA_HASH_HPP
+
+#include <cstdint>
+
+namespace sdata {
+
+/// Combine the value into the seed, the combined values are ordered. Mixed as splitmix64
+inline constexpr uint64_t hash_combine(uint64_t seed, uint64_t value) {
+  uint64_t hash = seed * 0x9e3779b97f4a7c15 + value;
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+  return hash ^ (hash >> 31);
+}
+
+}  // namespace sdata
+
+#endif
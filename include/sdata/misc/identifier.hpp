@@ -0,0 +1,49 @@
+#ifndef SDATA_IDENTIFIER_HPP
+#define SDATA_IDENTIFIER_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace sdata {
+
+enum IdentifierCharacter : uint8_t {
+  IDENTIFIER_TAIL = 1,
+  IDENTIFIER_HEAD = 2,
+};
+
+/// Classes of the characters in the Token::ID pattern {a|'_'} {a|n|'_'}*
+constexpr std::array<uint8_t, 256> IDENTIFIER_CHARACTERS = [] {
+  std::array<uint8_t, 256> table {};
+
+  for (size_t c = 0; c < table.size(); c++) {
+    bool is_head = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    bool is_tail = is_head || (c >= '0' && c <= '9');
+    table[c] = (is_head ? IDENTIFIER_HEAD : 0) | (is_tail ? IDENTIFIER_TAIL : 0);
+  }
+
+  return table;
+}();
+
+constexpr uint8_t identifier_character(char c) {
+  return IDENTIFIER_CHARACTERS[static_cast<uint8_t>(c)];
+}
+
+/// Does the identifier match the Token::ID pattern, the characters are checked without branching
+constexpr bool is_identifier(std::string_view id) {
+  if (id.empty()) {
+    return false;
+  }
+
+  uint8_t valid = identifier_character(id[0]) >> 1;
+
+  for (size_t n = 1; n < id.size(); n++) {
+    valid &= identifier_character(id[n]);
+  }
+
+  return valid;
+}
+
+}  // namespace sdata
+
+#endif
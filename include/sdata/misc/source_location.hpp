@@ -11,10 +11,18 @@ struct SourceLocation {
 public:
   SourceLocation(std::string_view source, std::string_view::iterator iterator) :
     source(source),
-    index(std::distance(source.cbegin(), iterator)),
-    line(std::count(source.cbegin(), iterator, '\n') + 1) {}
+    index(std::distance(source.cbegin(), iterator)) {}
 
-  SourceLocation() : source {}, index((size_t)-1), line((size_t)-1) {}
+  SourceLocation() : source {}, index((size_t)-1) {}
+
+  /// Line number, only counted on demand as it walks the whole source
+  inline size_t line() const {
+    if (index > source.size()) {
+      return (size_t)-1;
+    }
+
+    return std::count(source.cbegin(), source.cbegin() + index, '\n') + 1;
+  }
 
   constexpr inline std::string_view snippet() const {
     if (index >= source.size()) {
@@ -23,14 +31,14 @@ public:
 
     std::string_view s = {
       source.begin() + source.rfind('\n', index) + 1,
-      source.begin() + source.find('\n', index),
+      source.begin() + std::min(source.find('\n', index), source.size()),
     };
 
     return trim(s, ' ');
   }
 
   std::string_view source;
-  size_t index, line;
+  size_t index;
 };
 
 };  // namespace sdata
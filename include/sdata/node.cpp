@@ -1,6 +1,7 @@
 #include "node.hpp"
 #include "writer.hpp"
-#include <algorithm>
+#include <bit>
+#include <utility>
 
 namespace sdata {
 
@@ -18,26 +19,192 @@ std::string NodeException::message(std::string_view description, const Node *nod
   return fmt(PATTERN, description, Writer(*node, Format::inlined()).buffer());
 }
 
-template<typename S>
-auto *sequence_search(S &sequence, std::string_view id) {
-  auto match_fn = [id](auto &node) -> bool {
-    return node.id() == id;
+Sequence::Sequence(std::initializer_list<Node> members) : Base(members) {
+  if (size() > INDEX_THRESHOLD) {
+    reindex();
+  }
+}
+
+Sequence::Sequence(const Sequence &other) :
+  Base(other),
+  m_index(other.m_index ? std::make_unique<SequenceIndex>(*other.m_index) : nullptr) {}
+
+Sequence &Sequence::operator=(const Sequence &other) {
+  if (this != &other) {
+    Base::operator=(other);
+    m_index = other.m_index ? std::make_unique<SequenceIndex>(*other.m_index) : nullptr;
+  }
+  return *this;
+}
+
+Node *Sequence::find(Atom id) {
+  if (size() <= INDEX_THRESHOLD) {
+    return const_cast<Node *>(linear_search(id, 0));
+  }
+
+  if (!is_indexed()) {
+    reindex();
+  }
+
+  bool is_exact = true;
+  auto *found = const_cast<Node *>(index_search(id, is_exact));
+
+  if (!is_exact) {
+    refresh(id, found);
+  }
+  return found;
+}
+
+const Node *Sequence::find(Atom id) const {
+  bool is_exact = true;
+  return is_indexed() ? index_search(id, is_exact) : linear_search(id, 0);
+}
+
+Node *Sequence::find(std::string_view id) {
+  Atom atom = Atom::find(id);
+  return atom.empty() && !id.empty() ? nullptr : find(atom);
+}
+
+const Node *Sequence::find(std::string_view id) const {
+  Atom atom = Atom::find(id);
+  return atom.empty() && !id.empty() ? nullptr : find(atom);
+}
+
+void Sequence::push_back(const Node &member) {
+  Base::push_back(member);
+  index_back();
+}
+
+void Sequence::push_back(Node &&member) {
+  Base::push_back(std::move(member));
+  index_back();
+}
+
+bool Sequence::is_indexed() const {
+  return m_index && m_index->count <= size();
+}
+
+const Node *Sequence::index_search(Atom id, bool &is_exact) const {
+  const SequenceIndex::Slot &found = slot(id);
+  is_exact = false;
+
+  // Members renamed to the identifier since it was indexed may precede the indexed one
+  if (found.position == SequenceIndex::EMPTY ? id.renames() != 0 : found.renames != id.renames()) {
+    return linear_search(id, 0);
+  }
+
+  // The members appended past the index are searched linearly
+  if (found.position == SequenceIndex::EMPTY || found.position == SequenceIndex::ABSENT) {
+    is_exact = m_index->count == size();
+    return linear_search(id, m_index->count);
+  }
+
+  const Node &member = Base::operator[](found.position);
+
+  if (member.atom() == id) {
+    is_exact = true;
+    return &member;
+  }
+
+  // Renamed since, the following members with the identifier aren't indexed
+  return linear_search(id, found.position + 1);
+}
+
+const Node *Sequence::linear_search(Atom id, size_t position) const {
+  for (; position < size(); position++) {
+    if (Base::operator[](position).atom() == id) {
+      return &Base::operator[](position);
+    }
+  }
+
+  return nullptr;
+}
+
+SequenceIndex::Slot &Sequence::slot(Atom id) const {
+  std::vector<SequenceIndex::Slot> &slots = m_index->slots;
+  size_t mask = slots.size() - 1;
+  size_t n = id.hash() & mask;
+
+  while (slots[n].position != SequenceIndex::EMPTY && slots[n].id != id) {
+    n = (n + 1) & mask;
+  }
+
+  return slots[n];
+}
+
+void Sequence::refresh(Atom id, const Node *found) {
+  SequenceIndex::Slot &refreshed = slot(id);
+
+  if (refreshed.position == SequenceIndex::EMPTY) {
+    m_index->used++;
+  }
+
+  refreshed = {
+    id,
+    found ? static_cast<uint32_t>(found - Base::data()) : SequenceIndex::ABSENT,
+    id.renames(),
   };
 
-  auto iter = std::find_if(sequence.begin(), sequence.end(), match_fn);
-  return iter != sequence.end() ? &*iter : nullptr;
+  // Keep the load factor under one half
+  if (m_index->used * 2 > m_index->slots.size()) {
+    reindex();
+  }
+}
+
+void Sequence::index_back() {
+  if (size() <= INDEX_THRESHOLD) {
+    return;
+  }
+
+  if (!is_indexed() || (m_index->used + size() - m_index->count) * 2 > m_index->slots.size()) {
+    reindex();
+    return;
+  }
+
+  for (; m_index->count < size(); m_index->count++) {
+    Atom id = Base::operator[](m_index->count).atom();
+    SequenceIndex::Slot &appended = slot(id);
+
+    // Without renames to the identifier, no earlier member can have it
+    if (appended.position == SequenceIndex::EMPTY && id.renames() == 0) {
+      appended = {id, static_cast<uint32_t>(m_index->count), 0};
+      m_index->used++;
+    } else if (appended.position == SequenceIndex::ABSENT) {
+      appended.position = static_cast<uint32_t>(m_index->count);
+    }
+  }
+}
+
+void Sequence::reindex() {
+  if (!m_index) {
+    m_index = std::make_unique<SequenceIndex>();
+  }
+
+  m_index->slots.assign(std::bit_ceil(size() * 2), {});
+  m_index->used = 0;
+
+  for (m_index->count = 0; m_index->count < size(); m_index->count++) {
+    Atom id = Base::operator[](m_index->count).atom();
+    SequenceIndex::Slot &indexed = slot(id);
+
+    // Only the first member of an identifier is indexed
+    if (indexed.position == SequenceIndex::EMPTY) {
+      indexed = {id, static_cast<uint32_t>(m_index->count), id.renames()};
+      m_index->used++;
+    }
+  }
 }
 
 Node *Node::search(std::string_view id) {
-  return sequence_search(as<Sequence>(), id);
+  return as<Sequence>().find(id);
 }
 
 const Node *Node::search(std::string_view id) const {
-  return sequence_search(get<Sequence>(), id);
+  return get<Sequence>().find(id);
 }
 
 Node &Node::at(std::string_view id) {
-  Node *found = sequence_search(get<Sequence>(), id);
+  Node *found = get<Sequence>().find(id);
 
   if (!found) {
     throw_member_not_found(id);
@@ -47,7 +214,7 @@ Node &Node::at(std::string_view id) {
 }
 
 const Node &Node::at(std::string_view id) const {
-  const Node *found = sequence_search(get<Sequence>(), id);
+  const Node *found = get<Sequence>().find(id);
 
   if (!found) {
     throw_member_not_found(id);
@@ -65,11 +232,20 @@ Node &Node::insert(const Node &member) {
   Node *found = search(member.id());
 
   if (!found) {
-    Sequence &sequence = std::get<Sequence>(m_variant);
     return get<Sequence>().emplace_back(member);
   } else {
     return *found = member;
   }
 }
 
+Node &Node::insert(Node &&member) {
+  Node *found = search(member.id());
+
+  if (!found) {
+    return get<Sequence>().emplace_back(std::move(member));
+  } else {
+    return *found = std::move(member);
+  }
+}
+
 }  // namespace sdata
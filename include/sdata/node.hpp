@@ -2,8 +2,8 @@
 #define SDATA_NODE_HPP
 
 #include "misc/exception.hpp"
+#include "misc/identifier.hpp"
 #include "serializer.hpp"
-#include "token.hpp"
 #include "variant.hpp"
 #include <string_view>
 
@@ -25,31 +25,65 @@ private:
 class Node : public Variant {
 public:
   /// Nil node constructor
-  Node(std::string_view id) : m_id(parse_id(id)), Variant() {}
+  Node(std::string_view id) : Variant() {
+    m_id = Atom {parse_id(id)};
+  }
 
   /// Node constructor with variant data
-  Node(std::string_view id, auto data) : m_id(parse_id(id)), Variant(data) {}
+  Node(std::string_view id, auto data) : Variant(std::move(data)) {
+    m_id = Atom {parse_id(id)};
+  }
 
   /// Node sequence constructor
-  Node(std::string_view id, std::initializer_list<Node> sequence) :
-    m_id(parse_id(id)),
-    Variant(sequence) {}
+  Node(std::string_view id, std::initializer_list<Node> sequence) : Variant(sequence) {
+    m_id = Atom {parse_id(id)};
+  }
 
   /// Serialized node constructor
   template<typename T>
-  requires(is_serialized<T>) Node(std::string_view id, T serialized) :
-    m_id(parse_id(id)),
-    Variant(Sequence {}) {
+  requires(is_serialized<T>) Node(std::string_view id, T serialized) : Variant(Sequence {}) {
+    m_id = Atom {parse_id(id)};
     serialize<T>(serialized);
   }
 
+  /// Node of a borrowed identifier, identifiers are interned and never copied by the nodes
+  static Node borrow(std::string_view id, Variant data = {}) {
+    return Node {id, std::move(data)};
+  }
+
+  /// Node of an identifier already matched against the Token::ID pattern, it isn't checked again
+  static Node trusted(std::string_view id, Variant data = {}) {
+    Node node {"", std::move(data)};
+    node.m_id = Atom {id};
+    return node;
+  }
+
   Node(Node &&) = default;
   Node(const Node &) = default;
-  Node &operator=(const Node &) = default;
+
+  /// Member assignment, the identifier included
+  Node &operator=(Node &&other) noexcept {
+    Variant::operator=(std::move(other));
+    set_id(other.m_id);
+    return *this;
+  }
+
+  /// Member assignment, the identifier included
+  Node &operator=(const Node &other) {
+    Variant::operator=(other);
+    set_id(other.m_id);
+    return *this;
+  }
+
   using Variant::operator=;
   using Variant::operator[];
 
   inline std::string_view id() const {
+    return m_id.view();
+  }
+
+  /// Interned identifier, compared as an integer
+  inline Atom atom() const {
     return m_id;
   }
 
@@ -57,6 +91,11 @@ public:
     return m_id.empty();
   }
 
+  /// Replace the identifier
+  inline void rename(std::string_view id) {
+    set_id(Atom {parse_id(id)});
+  }
+
   /// Search a member by id in the sequence
   Node *search(std::string_view id);
 
@@ -72,17 +111,25 @@ public:
   /// Insert a new member in the sequence
   Node &insert(const Node &member);
 
+  /// Insert a new member in the sequence, moved
+  Node &insert(Node &&member);
+
   /// Construct a new member in the sequence
   inline Node &insert(std::string_view id, auto data) {
-    return insert(Node {id, data});
+    return insert(Node {id, std::move(data)});
   }
 
   /// Member insertion operator
   Node &operator[](std::string_view id);
 
+  /// Structural hash of the identifier and the value, see Variant::hash()
+  inline uint64_t hash() const {
+    return hash_combine(std::hash<std::string_view> {}(id()), Variant::hash());
+  }
+
   /// Recursive node compare
   inline bool operator==(const Node &other) const {
-    return id() == other.id() && Variant::operator==(other);
+    return m_id == other.m_id && Variant::operator==(other);
   }
 
   /// Deserialization operator
@@ -130,15 +177,23 @@ private:
     throw NodeException {fmt("Member named '{}' not found in node sequence", id), this};
   }
 
-  /// Check if the identifier matches the Token::ID pattern
-  std::string parse_id(std::string_view id) const {
-    if (!id.empty() && !Token::PATTERN.at(Token::ID).match(id)) {
+  /// Check if the identifier matches the Token::ID pattern, the node is anonymous until checked
+  std::string_view parse_id(std::string_view id) const {
+    if (!id.empty() && !is_identifier(id)) {
       throw NodeException {"Naming convention violation [a-z A-Z 0-9 _]", this};
     }
-    return std::string {id};
+    return id;
+  }
+
+  /// Identifier changes are counted by the atoms, for the sequence indexes
+  inline void set_id(Atom id) {
+    if (id != m_id) {
+      id.count_rename();
+      m_id = id;
+    }
   }
 
-  std::string m_id;
+  Atom m_id;
 };
 
 }  // namespace sdata
@@ -0,0 +1,43 @@
+#include "node_builder.hpp"
+
+namespace sdata {
+
+Node NodeBuilder::build() {
+  std::vector<size_t> duplicates {};
+
+  for (size_t n = 0; n < m_members.size(); n++) {
+    if (!m_members[n].is_anonymous() && m_members.find(m_members[n].atom()) != &m_members[n]) {
+      duplicates.push_back(n);
+    }
+  }
+
+  if (!duplicates.empty()) {
+    // The values are moved to the first members before any of them is moved, the positions found
+    // by the index are still valid
+    for (size_t n : duplicates) {
+      static_cast<Variant &>(*m_members.find(m_members[n].atom())) = std::move(m_members[n]);
+    }
+
+    size_t size = 0;
+
+    for (size_t n = 0, duplicate = 0; n < m_members.size(); n++) {
+      if (duplicate < duplicates.size() && duplicates[duplicate] == n) {
+        duplicate++;
+      } else if (size++ != n) {
+        m_members[size - 1] = std::move(m_members[n]);
+      }
+    }
+
+    m_members.erase(m_members.begin() + size, m_members.end());
+  }
+
+  return build_unchecked();
+}
+
+Node NodeBuilder::build_unchecked() {
+  m_node = std::move(m_members);
+  m_members = Sequence {};
+  return std::move(m_node);
+}
+
+}  // namespace sdata
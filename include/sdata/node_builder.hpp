@@ -0,0 +1,57 @@
+#ifndef SDATA_NODE_BUILDER_HPP
+#define SDATA_NODE_BUILDER_HPP
+
+#include "node.hpp"
+
+namespace sdata {
+
+// Builds the sequence of a node from appended members. Unlike Node::insert(), the members are
+// moved and appended without searching the previous ones, the identifiers are checked once by
+// build() through the sequence index. The builder is left empty by the builds.
+class NodeBuilder {
+public:
+  explicit NodeBuilder(std::string_view id) : m_node(id) {}
+
+  NodeBuilder &reserve(size_t capacity) {
+    m_members.reserve(capacity);
+    return *this;
+  }
+
+  NodeBuilder &append(Node &&member) {
+    m_members.push_back(std::move(member));
+    return *this;
+  }
+
+  NodeBuilder &append(const Node &member) {
+    m_members.push_back(member);
+    return *this;
+  }
+
+  /// Construct a new member
+  template<typename T>
+  NodeBuilder &append(std::string_view id, T data) {
+    m_members.emplace_back(id, std::move(data));
+    return *this;
+  }
+
+  /// Appended members count
+  inline size_t size() const {
+    return m_members.size();
+  }
+
+  /// Node of the members, a member with the identifier of a previous one replaces its value as
+  /// with Node::insert(). Unlike Node::insert(), which replaces the first anonymous member, the
+  /// anonymous members are all kept as in a parsed sequence
+  Node build();
+
+  /// Node of the members, the caller guarantees their identifiers are distinct
+  Node build_unchecked();
+
+private:
+  Node m_node;
+  Sequence m_members;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,266 @@
+#include "parallel_parser.hpp"
+#include <atomic>
+#include <system_error>
+#include <thread>
+
+namespace sdata {
+
+// Below this member count the thread startup costs more than the parsing
+constexpr size_t PARALLEL_MIN_MEMBERS = 64;
+// Chunks per thread, more chunks balance the load of unevenly sized members
+constexpr size_t PARALLEL_CHUNK_FACTOR = 4;
+
+template<typename T>
+struct ParallelChunk {
+  size_t begin, end;
+  T result {};
+};
+
+// Split the [begin, end) range on the boundaries closest to the chunk size, the boundary
+// characters are excluded from the chunks when separated
+template<typename T>
+static std::vector<ParallelChunk<T>> split_chunks(
+  size_t begin,
+  size_t end,
+  const std::vector<size_t> &boundaries,
+  size_t chunk_count,
+  bool separated) {
+  std::vector<ParallelChunk<T>> chunks {};
+  size_t chunk_size = (end - begin) / std::max<size_t>(chunk_count, 1) + 1;
+
+  for (size_t boundary : boundaries) {
+    if (boundary - begin >= chunk_size) {
+      chunks.push_back({begin, boundary});
+      begin = boundary + separated;
+    }
+  }
+
+  chunks.push_back({begin, end});
+  return chunks;
+}
+
+// Parse the chunks on the worker threads pulling them from a shared counter.
+// Returns false when a chunk failed, the remaining chunks are abandoned
+template<typename T, typename F>
+static bool parse_chunks(std::vector<ParallelChunk<T>> &chunks, size_t thread_count, F parse) {
+  std::atomic<size_t> next_chunk {0};
+  std::atomic<bool> failed {false};
+
+  auto work = [&] {
+    for (size_t i; !failed && (i = next_chunk++) < chunks.size();) {
+      try {
+        chunks[i].result = parse(chunks[i].begin, chunks[i].end);
+      } catch (const std::exception &) {
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads {};
+
+  try {
+    for (size_t i = 1; i < std::min(thread_count, chunks.size()); i++) {
+      threads.emplace_back(work);
+    }
+  } catch (const std::system_error &) {
+    // Out of threads, the chunks are pulled by the threads already started
+  }
+
+  work();
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  return !failed;
+}
+
+// Move the chunk results into the container in the source order
+template<typename C, typename T>
+static void splice_chunks(C &container, std::vector<ParallelChunk<T>> &chunks) {
+  size_t size = container.size();
+
+  for (auto &chunk : chunks) {
+    size += chunk.result.size();
+  }
+
+  container.reserve(size);
+
+  for (auto &chunk : chunks) {
+    auto &result = chunk.result;
+    container.insert(
+      container.end(), std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+  }
+}
+
+ParallelParser::ParallelParser(std::string_view source, size_t thread_count) :
+  m_source(source),
+  m_skimmer(source),
+  m_thread_count(thread_count != 0 ? thread_count : std::thread::hardware_concurrency()) {}
+
+Node ParallelParser::parse() {
+  if (m_thread_count > 1) {
+    if (auto root = skim_root()) {
+      if (auto node = parse_root(*root)) {
+        return std::move(*node);
+      }
+    }
+  }
+
+  return Parser(m_source).parse();
+}
+
+std::vector<Node> ParallelParser::parse_records() {
+  if (m_thread_count > 1) {
+    if (auto records = parse_records_parallel()) {
+      return std::move(*records);
+    }
+  }
+
+  Parser parser {m_source};
+  std::vector<Node> records {};
+
+  while (auto record = parser.parse_next()) {
+    records.push_back(std::move(*record));
+  }
+
+  return records;
+}
+
+std::optional<ParallelParser::Root> ParallelParser::skim_root() const {
+  Root root {};
+  size_t n = m_skimmer.skip_ignored(0);
+
+  if (n >= m_source.size()) {
+    return std::nullopt;
+  }
+
+  // Named root, either a sequence or an array variant
+  if (m_source[n] != '{') {
+    size_t id_end = m_skimmer.skip_word(n);
+
+    if (id_end == Skimmer::npos) {
+      return std::nullopt;
+    }
+
+    root.id = m_source.substr(n, id_end - n);
+
+    if ((n = m_skimmer.skip_ignored(id_end)) >= m_source.size()) {
+      return std::nullopt;
+    }
+
+    if (m_source[n] == ':') {
+      n = m_skimmer.skip_ignored(n + 1);
+      root.is_array = true;
+    }
+  }
+
+  if (n >= m_source.size() || m_source[n] != (root.is_array ? '[' : '{')) {
+    return std::nullopt;
+  }
+
+  char close = root.is_array ? ']' : '}';
+  root.begin = n + 1;
+
+  while (true) {
+    n = root.is_array ? m_skimmer.skip_variant(n + 1) : m_skimmer.skip_node(n + 1);
+
+    if ((n = m_skimmer.skip_ignored(n)) >= m_source.size()) {
+      return std::nullopt;
+    }
+
+    if (m_source[n] == close) {
+      root.end = n;
+      break;
+    } else if (m_source[n] == ',') {
+      root.separators.push_back(n);
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  if (root.separators.size() + 1 < PARALLEL_MIN_MEMBERS) {
+    return std::nullopt;
+  }
+
+  return root;
+}
+
+std::optional<Node> ParallelParser::parse_root(const Root &root) const {
+  size_t chunk_count = m_thread_count * PARALLEL_CHUNK_FACTOR;
+
+  try {
+    if (root.is_array) {
+      auto chunks = split_chunks<Array>(root.begin, root.end, root.separators, chunk_count, true);
+
+      auto parse = [this](size_t begin, size_t end) {
+        return Parser(m_source, begin, end).parse_items();
+      };
+
+      if (!parse_chunks(chunks, m_thread_count, parse)) {
+        return std::nullopt;
+      }
+
+      Array array {};
+      splice_chunks(array, chunks);
+      return Node {root.id, std::move(array)};
+    } else {
+      auto chunks = split_chunks<Sequence>(root.begin, root.end, root.separators, chunk_count, true);
+
+      auto parse = [this](size_t begin, size_t end) {
+        return Parser(m_source, begin, end).parse_members();
+      };
+
+      if (!parse_chunks(chunks, m_thread_count, parse)) {
+        return std::nullopt;
+      }
+
+      Sequence sequence {};
+      splice_chunks(sequence, chunks);
+      return Node {root.id, std::move(sequence)};
+    }
+  } catch (const std::exception &) {
+    // Invalid root identifier, reported by the serial parser
+    return std::nullopt;
+  }
+}
+
+std::optional<std::vector<Node>> ParallelParser::parse_records_parallel() const {
+  std::vector<size_t> ends {};
+  size_t n = 0;
+
+  while ((n = m_skimmer.skip_ignored(n)) < m_source.size()) {
+    if ((n = m_skimmer.skip_node(n)) == Skimmer::npos) {
+      return std::nullopt;
+    }
+    ends.push_back(n);
+  }
+
+  if (ends.size() < PARALLEL_MIN_MEMBERS) {
+    return std::nullopt;
+  }
+
+  size_t chunk_count = m_thread_count * PARALLEL_CHUNK_FACTOR;
+  auto chunks = split_chunks<std::vector<Node>>(0, m_source.size(), ends, chunk_count, false);
+
+  auto parse = [this](size_t begin, size_t end) {
+    Parser parser {m_source, begin, end};
+    std::vector<Node> records {};
+
+    while (auto record = parser.parse_next()) {
+      records.push_back(std::move(*record));
+    }
+
+    return records;
+  };
+
+  if (!parse_chunks(chunks, m_thread_count, parse)) {
+    return std::nullopt;
+  }
+
+  std::vector<Node> records {};
+  splice_chunks(records, chunks);
+  return records;
+}
+
+}  // namespace sdata
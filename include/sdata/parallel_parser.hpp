@@ -0,0 +1,43 @@
+#ifndef SDATA_PARALLEL_PARSER_HPP
+#define SDATA_PARALLEL_PARSER_HPP
+
+#include "parser.hpp"
+#include "skimmer.hpp"
+
+namespace sdata {
+
+// Parses the members of the root sequence or array, or consecutive records, concurrently.
+// A structural pre-pass splits the source on its boundaries, the ranges are parsed by worker
+// threads pulling chunks from a shared counter and the results are spliced in source order.
+// Any failure falls back to the serial parser, so both the results and the reported errors match
+// Parser::parse() and Parser::parse_next().
+class ParallelParser {
+public:
+  /// Uses the hardware concurrency when the thread count is zero
+  explicit ParallelParser(std::string_view source, size_t thread_count = 0);
+
+  Node parse();
+
+  /// Parse every top-level node of the source
+  std::vector<Node> parse_records();
+
+private:
+  struct Root {
+    std::string_view id;
+    bool is_array;
+    size_t begin, end;
+    std::vector<size_t> separators;
+  };
+
+  std::optional<Root> skim_root() const;
+  std::optional<Node> parse_root(const Root &root) const;
+  std::optional<std::vector<Node>> parse_records_parallel() const;
+
+  std::string_view m_source;
+  Skimmer m_skimmer;
+  size_t m_thread_count;
+};
+
+}  // namespace sdata
+
+#endif
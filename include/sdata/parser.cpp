@@ -1,54 +1,175 @@
 #include "parser.hpp"
+#include "misc/digits.hpp"
 #include "misc/parse_number.hpp"
 #include "misc/trim.hpp"
+#include "skimmer.hpp"
 
 namespace sdata {
 
-Parser::Parser(std::string_view source) : m_scanner(source) {}
+/// Position following the last character of the token
+static size_t token_end(const Token &token) {
+  return token.source_location.index + token.expression.size();
+}
 
-std::optional<Node> Parser::parse_node(bool required) {
-  Token token = required ? parse_token(Token::ID | Token::BEG_SEQ | Token::DONE)
-                         : parse_token(Token::ID | Token::BEG_SEQ);
+Parser::Parser(std::string_view source, ParserOptions options) :
+  Parser(source, 0, source.size(), options) {}
 
-  // No token available
-  if (token.category & Token::DONE) {
-    return std::nullopt;
-  }
+Parser::Parser(std::string_view source, size_t begin, size_t end, ParserOptions options) :
+  m_scanner(source, begin, end),
+  m_options(options),
+  m_stack(),
+  m_result(),
+  m_span(),
+  m_state(ROOT),
+  m_depth(0),
+  m_skip(false),
+  m_done(false) {}
 
-  // Anonymous node
-  if (token.category & Token::BEG_SEQ) {
-    return Node {"", parse_sequence()};
+bool Parser::step(size_t token_budget) {
+  for (; !m_done && token_budget > 0; token_budget--) {
+    m_done = advance(parse_token(EXPECTED[m_state]));
   }
 
-  Node node {token.expression, nullptr};
-  Token assignment = parse_token(Token::ASSIGNMENT);
-
-  if (assignment.category & Token::SET) {
-    node = parse_variant();
-  }
-  if (assignment.category & Token::BEG_SEQ) {
-    node = parse_sequence();
-  }
-
-  return node;
+  return m_done;
 }
 
-Variant Parser::parse_sequence() {
+Sequence Parser::parse_members() {
   Sequence sequence {};
 
   do {
     sequence.push_back(*parse_node(true));
-  } while (parse_token(Token::SEPARATOR | Token::END_SEQ).category != Token::END_SEQ);
+  } while (parse_token(Token::SEPARATOR | Token::DONE).category != Token::DONE);
+
+  return sequence;
+}
+
+Array Parser::parse_items() {
+  Array array {};
+
+  do {
+    array.push_back(parse_variant());
+  } while (parse_token(Token::SEPARATOR | Token::DONE).category != Token::DONE);
+
+  return array;
+}
+
+std::optional<Node> Parser::parse_node(bool required) {
+  return run(required ? NODE : ROOT);
+}
+
+Variant Parser::parse_sequence(const Token &token) {
+  // The sequence token is already consumed, the bottom frame completes on its end
+  m_state = NODE;
+  open_container(token, Frame::SEQUENCE);
 
-  return {sequence};
+  return *run(NODE);
 }
 
 Variant Parser::parse_variant() {
-  Token token = parse_token(Token::DATA);
+  // Anonymous member receiving the value, its span starts with the value
+  m_stack.push_back({Frame::MEMBER, Node {""}, {.begin = std::string_view::npos}});
+  return *run(VALUE);
+}
+
+Variant Parser::parse_array(const Token &token) {
+  m_stack.push_back({Frame::MEMBER, Node {""}, {.begin = std::string_view::npos}});
+  open_container(token, Frame::ARRAY);
+
+  return *run(parse_numbers());
+}
+
+Parser::State Parser::parse_numbers() {
+  // The items spans are only recorded by the token path
+  if (m_skip || m_options.spans) {
+    return VALUE;
+  }
+
+  std::string_view source = m_scanner.source().substr(0, m_scanner.end());
+  Array &array = m_stack.back().node.get<Array>();
+  State state = VALUE;
+  Variant number {};
+
+  // Numbers followed by a separator or the array end, anything else is left to the token path
+  // which reports the errors
+  for (size_t n = m_scanner.position(); parse_number_at(n, number);) {
+    array.push_back(std::move(number));
+    m_scanner.seek(n);
+    state = ARRAY_NEXT;
+
+    while (n < source.size() && Skimmer::is_blank(source[n])) {
+      n++;
+    }
+
+    if (n == source.size() || source[n] != ',') {
+      break;
+    }
+
+    m_scanner.seek(++n);
+    state = VALUE;
+  }
+
+  return state;
+}
+
+bool Parser::parse_number_at(size_t &n, Variant &number) const {
+  std::string_view source = m_scanner.source().substr(0, m_scanner.end());
+
+  while (n < source.size() && Skimmer::is_blank(source[n])) {
+    n++;
+  }
+
+  size_t begin = n;
+  bool negative = n < source.size() && source[n] == '-';
+  size_t digits = n + negative;
+  size_t end = skip_digits(source, digits);
+  bool is_float = end < source.size() && source[end] == '.';
 
+  if (end == digits) {
+    return false;
+  }
+
+  if (is_float) {
+    size_t fraction = end + 1;
+
+    if ((end = skip_digits(source, fraction)) == fraction) {
+      return false;
+    }
+  }
+
+  size_t last = end + (is_float && end < source.size() && source[end] == 'f');
+
+  // The number must end on a separator, the array end or a blank
+  if (last == source.size() || (!Skimmer::is_blank(source[last]) && source[last] != ',' &&
+                                 source[last] != ']')) {
+    return false;
+  }
+
+  if (is_float) {
+    float value {};
+    auto [ptr, status] = std::from_chars(source.data() + begin, source.data() + end, value);
+
+    if (status != std::errc {}) {
+      return false;
+    }
+    number = value;
+  } else {
+    uint64_t value = parse_digits(source.substr(digits, end - digits));
+    uint64_t max = uint64_t {std::numeric_limits<int>::max()} + negative;
+
+    if (value > max) {
+      return false;
+    }
+    number = static_cast<int>(negative ? -static_cast<int64_t>(value) : value);
+  }
+
+  n = last;
+  return true;
+}
+
+Variant Parser::parse_data(const Token &token) {
   switch (token.category) {
     case Token::BEG_ARR: {
-      return parse_array();
+      return parse_array(token);
     }
 
     case Token::FLOAT: {
@@ -68,26 +189,347 @@ Variant Parser::parse_variant() {
     }
 
     case Token::STRING: {
-      // Trim the quotes from the content
-      std::string_view content = token.expression;
-      content.remove_prefix(1);
-      content.remove_suffix(1);
+      std::string_view content = parse_string(token);
+
+      if (!is_escaped(content)) {
+        return {m_options.borrow ? String::borrow(content) : String {content}};
+      }
 
-      return {std::string(content)};
+      return {m_options.borrow ? String::borrow_escaped(content) : String {unescape(content)}};
     };
 
     default: return {nullptr};
   }
 }
 
-Variant Parser::parse_array() {
-  Array array {};
+// Container overwritten by Parser::parse_into(), the children past the count are dropped
+struct ReusedContainer {
+  Variant *variant;
+  size_t count;
+};
 
-  do {
-    array.push_back(parse_variant());
-  } while (parse_token(Token::SEPARATOR | Token::END_ARR).category != Token::END_ARR);
+// Next child of the container, reused when available
+template<typename C>
+static auto &reuse_child(ReusedContainer &container) {
+  C &children = container.variant->get<C>();
+
+  if (container.count++ < children.size()) {
+    return children[container.count - 1];
+  }
+
+  if constexpr (std::same_as<C, Sequence>) {
+    return children.emplace_back("");
+  } else {
+    return children.emplace_back();
+  }
+}
+
+void Parser::parse_into(Node &node) {
+  // Reused between the calls, reparsing the same shape doesn't allocate
+  static thread_local std::vector<ReusedContainer> containers {};
+  containers.clear();
+
+  Node *member = &node;
+  Variant *value = &node;
+  m_state = ROOT;
+
+  while (true) {
+    Token token = parse_token(EXPECTED[m_state]);
+
+    switch (token.category) {
+      case Token::DONE: {
+        node.rename("");
+        node = nullptr;
+        return;
+      }
+
+      case Token::ID: {
+        member = containers.empty() ? &node : &reuse_child<Sequence>(containers.back());
+        member->rename(token.expression);
+        m_state = ASSIGNMENT;
+        continue;
+      }
+
+      case Token::SET: {
+        value = member;
+        m_state = VALUE;
+        continue;
+      }
+
+      case Token::BEG_SEQ: {
+        enter_container(token);
+
+        // Anonymous member
+        if (m_state != ASSIGNMENT) {
+          member = containers.empty() ? &node : &reuse_child<Sequence>(containers.back());
+          member->rename("");
+        }
+
+        if (!member->is<Sequence>()) {
+          *member = Sequence {};
+        }
+
+        containers.push_back({member, 0});
+        m_state = NODE;
+        continue;
+      }
+
+      case Token::BEG_ARR: {
+        enter_container(token);
+
+        if (!value->is<Array>()) {
+          *value = Array {};
+        }
+
+        containers.push_back({value, 0});
+        value = &reuse_child<Array>(containers.back());
+        continue;
+      }
+
+      case Token::SEPARATOR: {
+        if (containers.back().variant->is<Array>()) {
+          value = &reuse_child<Array>(containers.back());
+          m_state = VALUE;
+        } else {
+          m_state = NODE;
+        }
+        continue;
+      }
+
+      case Token::END_SEQ: {
+        auto &sequence = containers.back().variant->get<Sequence>();
+        sequence.erase(sequence.begin() + containers.back().count, sequence.end());
+        containers.pop_back();
+        m_depth--;
+        break;
+      }
+
+      case Token::END_ARR: {
+        auto &array = containers.back().variant->get<Array>();
+        array.erase(array.begin() + containers.back().count, array.end());
+        containers.pop_back();
+        m_depth--;
+        break;
+      }
+
+      default: {
+        parse_data_into(token, *value);
+        break;
+      }
+    }
+
+    // A value or a container is completed
+    if (containers.empty()) {
+      return;
+    }
+
+    m_state = containers.back().variant->is<Array>() ? ARRAY_NEXT : SEQUENCE_NEXT;
+  }
+}
+
+void Parser::parse_data_into(const Token &token, Variant &variant) {
+  if (token.category != Token::STRING) {
+    variant = parse_data(token);
+    return;
+  }
+
+  std::string_view content = parse_string(token);
+
+  if (!variant.is<String>()) {
+    variant = String {};
+  }
+
+  if (is_escaped(content)) {
+    variant.get<String>().assign_escaped(content);
+  } else {
+    variant.get<String>().assign(content);
+  }
+}
+
+void Parser::skip_member(const Token &assignment) {
+  m_skip = true;
+
+  if (assignment.category & Token::BEG_SEQ) {
+    parse_sequence(assignment);
+  } else {
+    parse_variant();
+  }
+
+  m_skip = false;
+}
+
+std::optional<Node> Parser::run(State state) {
+  m_state = state;
+  m_result.reset();
+
+  while (!advance(parse_token(EXPECTED[m_state]))) {
+  }
+
+  return std::move(m_result);
+}
+
+bool Parser::advance(const Token &token) {
+  switch (token.category) {
+    // End of the source in the root state, no node available
+    case Token::DONE: {
+      return true;
+    }
+
+    case Token::ID: {
+      m_stack.push_back({
+        Frame::MEMBER,
+        m_skip ? Node {""} : parse_id(token),
+        {.begin = token.source_location.index},
+      });
+      m_state = ASSIGNMENT;
+      return false;
+    }
+
+    case Token::SET: {
+      m_state = VALUE;
+      return false;
+    }
+
+    case Token::BEG_SEQ: {
+      open_container(token, Frame::SEQUENCE);
+      m_state = NODE;
+      return false;
+    }
+
+    case Token::BEG_ARR: {
+      open_container(token, Frame::ARRAY);
+      m_state = parse_numbers();
+      return false;
+    }
+
+    case Token::SEPARATOR: {
+      m_state = m_stack.back().kind == Frame::SEQUENCE ? NODE : VALUE;
+      return false;
+    }
+
+    case Token::END_SEQ: {
+      Frame frame = std::move(m_stack.back());
+      m_stack.pop_back();
+      m_depth--;
+      frame.span.end = frame.span.value_end = token_end(token);
+
+      // The parser owns the completed boxes, the copies of the parsed tree share them
+      frame.node.share();
+      return complete_node(std::move(frame.node), std::move(frame.span));
+    }
+
+    case Token::END_ARR: {
+      Frame frame = std::move(m_stack.back());
+      m_stack.pop_back();
+      m_depth--;
+      if (!m_skip && std::as_const(frame.node).get<Array>().size() >= PackedArray::PACK_THRESHOLD) {
+        frame.node.pack();
+      }
+
+      frame.node.share();
+      frame.span.end = frame.span.value_end = token_end(token);
+      return complete_value(std::move(frame.node), std::move(frame.span));
+    }
+
+    default: {
+      size_t begin = token.source_location.index;
+      size_t end = token_end(token);
+
+      return complete_value(m_skip ? Variant {} : parse_data(token), {begin, end, begin, end});
+    }
+  }
+}
+
+void Parser::open_container(const Token &token, Frame::Kind kind) {
+  enter_container(token);
+
+  size_t begin = token.source_location.index;
+
+  if (kind == Frame::ARRAY) {
+    m_stack.push_back({Frame::ARRAY, m_skip ? Node {""} : Node {"", Array {}}, {begin, 0, begin}});
+  } else if (m_state == ASSIGNMENT) {
+    // Named sequence, the member frame becomes the sequence frame
+    m_stack.back().kind = Frame::SEQUENCE;
+    m_stack.back().node = m_skip ? Variant {} : Variant {Sequence {}};
+    m_stack.back().span.value_begin = begin;
+  } else {
+    m_stack.push_back({
+      Frame::SEQUENCE,
+      m_skip ? Node {""} : Node {"", Sequence {}},
+      {begin, 0, begin},
+    });
+  }
+}
+
+void Parser::enter_container(const Token &token) {
+  if (++m_depth > m_options.max_depth) {
+    throw ParserException {fmt("Maximum nesting depth of {} exceeded", m_options.max_depth), token};
+  }
+}
+
+bool Parser::complete_value(Variant &&value, SourceSpan &&span) {
+  Frame &frame = m_stack.back();
+
+  if (frame.kind == Frame::ARRAY) {
+    if (!m_skip) {
+      frame.node.get<Array>().push_back(std::move(value));
+    }
+    if (m_options.spans && !m_skip) {
+      frame.span.children.push_back(std::move(span));
+    }
+    m_state = ARRAY_NEXT;
+    return false;
+  }
+
+  Node node = std::move(frame.node);
+  SourceSpan member = std::move(frame.span);
+  m_stack.pop_back();
+
+  if (!m_skip) {
+    node = std::move(value);
+  }
+
+  if (m_options.spans) {
+    // Anonymous value members start with their value
+    member.begin = std::min(member.begin, span.begin);
+    member.end = span.end;
+    member.value_begin = span.value_begin;
+    member.value_end = span.value_end;
+    member.children = std::move(span.children);
+  }
+
+  return complete_node(std::move(node), std::move(member));
+}
+
+bool Parser::complete_node(Node &&node, SourceSpan &&span) {
+  if (m_stack.empty()) {
+    m_result = std::move(node);
+    m_span = std::move(span);
+    return true;
+  }
+
+  if (!m_skip) {
+    m_stack.back().node.get<Sequence>().push_back(std::move(node));
+  }
+  if (m_options.spans && !m_skip) {
+    m_stack.back().span.children.push_back(std::move(span));
+  }
+
+  m_state = SEQUENCE_NEXT;
+  return false;
+}
+
+Node Parser::parse_id(const Token &token) {
+  return Node::trusted(token.expression);
+}
+
+std::string_view Parser::parse_string(const Token &token) {
+  // Trim the quotes from the content
+  std::string_view content = token.expression;
+  content.remove_prefix(1);
+  content.remove_suffix(1);
 
-  return {array};
+  return content;
 }
 
 Token Parser::parse_token(unsigned expected) {
@@ -4,7 +4,10 @@
 #include "misc/assert.hpp"
 #include "node.hpp"
 #include "scanner.hpp"
+#include <array>
+#include <chrono>
 #include <optional>
+#include <vector>
 
 namespace sdata {
 
@@ -14,24 +17,252 @@ public:
     CodeException("sdata::ParserException", description, token) {}
 };
 
+struct ParserOptions {
+  /// Maximum number of nested sequences and arrays
+  size_t max_depth = 256;
+
+  /// Reference the strings from the source instead of copying them, the source must outlive
+  /// the parsed nodes. Identifiers are interned in both cases
+  bool borrow = false;
+
+  /// Record the source span of every parsed node, see Parser::span()
+  bool spans = false;
+};
+
+// Source range of a node, the children are the spans of the sequence members or array items
+struct SourceSpan {
+  /// Whole node, from the identifier to the end of the value
+  size_t begin = 0;
+  size_t end = 0;
+
+  /// Value only, brackets included for sequences and arrays
+  size_t value_begin = 0;
+  size_t value_end = 0;
+
+  std::vector<SourceSpan> children = {};
+
+  bool operator==(const SourceSpan &) const = default;
+};
+
+// Iterative parser, the nodes under construction are kept on an explicit stack and each token
+// drives a state transition. The native stack usage doesn't depend on the source nesting.
 class Parser {
 public:
-  explicit Parser(std::string_view source);
+  explicit Parser(std::string_view source, ParserOptions options = {});
+
+  /// Parser restricted to the [begin, end) range of the source
+  Parser(std::string_view source, size_t begin, size_t end, ParserOptions options = {});
 
   inline Node parse() {
     return parse_node(false).value_or(Node {"", nullptr});
   }
 
+  /// Parse the next top-level node, std::nullopt once the source is exhausted
+  inline std::optional<Node> parse_next() {
+    return parse_node(false);
+  }
+
+  /// Advance the root node parsing by at most the token budget, the position and the partial
+  /// tree are kept between the calls. Returns true once the root node is parsed, see result()
+  bool step(size_t token_budget);
+
+  /// Advance the root node parsing for about the time budget, see step(size_t)
+  template<typename R, typename P>
+  bool step(std::chrono::duration<R, P> time_budget) {
+    auto deadline = std::chrono::steady_clock::now() + time_budget;
+
+    // The clock is only read between token batches
+    while (!step(STEP_TOKENS)) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /// Root node parsed by step(), as returned by parse()
+  inline Node result() {
+    return std::move(m_result).value_or(Node {"", nullptr});
+  }
+
+  /// Parse separated sequence members until the end of the source
+  Sequence parse_members();
+
+  /// Parse separated array items until the end of the source
+  Array parse_items();
+
+  /// Span of the last parsed node, only recorded with ParserOptions::spans
+  inline const SourceSpan &span() const {
+    return m_span;
+  }
+
+  /// Parse the root node over an existing tree, the values are overwritten in place and the
+  /// containers and string buffers are reused, only the structural differences allocate.
+  /// The identifiers and strings are always copied, the tree is partially overwritten on errors
+  void parse_into(Node &node);
+
+  /// Parse the root node straight into a serialized object without building the node tree
+  template<typename T>
+  requires(is_serialized<T>) void parse_into(T &object) {
+    Token token = parse_token(Token::ID | Token::BEG_SEQ);
+
+    // Anonymous root, the sequence is already opened
+    if (token.category & Token::BEG_SEQ) {
+      return parse_member(object, token);
+    }
+
+    parse_member(object, parse_token(Token::ASSIGNMENT));
+  }
+
 private:
+  constexpr static size_t STEP_TOKENS = 256;
+
+  enum State {
+    ROOT,
+    NODE,
+    ASSIGNMENT,
+    VALUE,
+    SEQUENCE_NEXT,
+    ARRAY_NEXT,
+    STATE_COUNT,
+  };
+
+  /// Tokens accepted by each state
+  constexpr static std::array<unsigned, STATE_COUNT> EXPECTED {
+    Token::ID | Token::BEG_SEQ | Token::DONE,
+    Token::ID | Token::BEG_SEQ,
+    Token::ASSIGNMENT,
+    Token::DATA,
+    Token::SEPARATOR | Token::END_SEQ,
+    Token::SEPARATOR | Token::END_ARR,
+  };
+
+  struct Frame {
+    enum Kind {
+      MEMBER,
+      SEQUENCE,
+      ARRAY,
+    } kind;
+
+    Node node;
+    SourceSpan span = {};
+  };
+
   std::optional<Node> parse_node(bool required);
-  Variant parse_sequence();
+  Variant parse_sequence(const Token &token);
   Variant parse_variant();
-  Variant parse_array();
+  Variant parse_data(const Token &token);
+  Variant parse_array(const Token &token);
+  State parse_numbers();
+  bool parse_number_at(size_t &n, Variant &number) const;
+  void skip_member(const Token &assignment);
+
+  /// Run the state machine until the bottom frame or a root node is completed
+  std::optional<Node> run(State state);
+  bool advance(const Token &token);
+  bool complete_value(Variant &&value, SourceSpan &&span);
+  bool complete_node(Node &&node, SourceSpan &&span);
+  void open_container(const Token &token, Frame::Kind kind);
+  void enter_container(const Token &token);
+  void parse_data_into(const Token &token, Variant &variant);
+
+  template<typename T>
+  void parse_member(T &data, const Token &assignment) {
+    using D = std::decay_t<T>;
+
+    if constexpr (is_schemed<D>) {
+      if (!(assignment.category & Token::BEG_SEQ)) {
+        throw_unexpected_token(assignment, Token::BEG_SEQ);
+      }
+      parse_scheme(data);
+    } else if constexpr (is_converted<D>) {
+      Node node {"", assignment.category & Token::BEG_SEQ ? parse_sequence(assignment) : parse_variant()};
+      Serializer<D>().decode(node, data);
+    } else {
+      if (!(assignment.category & Token::SET)) {
+        throw_unexpected_token(assignment, Token::SET);
+      }
+
+      Token token = parse_token(Token::DATA);
+
+      // String views reference the source instead of a temporary variant
+      if constexpr (std::same_as<D, std::string_view>) {
+        if (token.category & Token::STRING) {
+          if (is_escaped(data = parse_string(token))) {
+            throw ParserException {"Escaped strings can't be viewed from the source", token};
+          }
+          return;
+        }
+      }
+
+      data = parse_data(token).template get<D>();
+    }
+  }
+
+  template<typename S>
+  void parse_scheme(S &schemed) {
+    auto map = Serializer<S>().map(schemed);
+    std::array<bool, std::tuple_size_v<decltype(map)>> found {};
+    Token token {};
+
+    do {
+      Token member = parse_token(Token::ID | Token::BEG_SEQ);
+
+      // Anonymous members can't be mapped to a property
+      if (member.category & Token::BEG_SEQ) {
+        skip_member(member);
+        continue;
+      }
+
+      Token assignment = parse_token(Token::ASSIGNMENT);
+      bool matched = false;
+      size_t index = 0;
+
+      auto visitor = [&](auto &property) {
+        // Only the first occurrence is deserialized, as with Node::at()
+        if (!matched && !found[index] && property.id == member.expression) {
+          parse_member(property.data, assignment);
+          matched = found[index] = true;
+        }
+        index++;
+      };
+
+      Serializer<S>::visit(visitor, map);
+
+      if (!matched) {
+        skip_member(assignment);
+      }
+    } while ((token = parse_token(Token::SEPARATOR | Token::END_SEQ)).category != Token::END_SEQ);
+
+    size_t index = 0;
+
+    auto visitor = [&](const auto &property) {
+      if (!found[index++]) {
+        throw ParserException {
+          fmt("Member named '{}' not found in node sequence", property.id),
+          token,
+        };
+      }
+    };
+
+    Serializer<S>::visit(visitor, map);
+  }
 
+  Node parse_id(const Token &token);
+  std::string_view parse_string(const Token &token);
   Token parse_token(unsigned expected = Token::NONE);
   void throw_unexpected_token(const Token &token, unsigned expected);
 
   Scanner m_scanner;
+  ParserOptions m_options;
+  std::vector<Frame> m_stack;
+  std::optional<Node> m_result;
+  SourceSpan m_span;
+  State m_state;
+  size_t m_depth;
+  bool m_skip;
+  bool m_done;
 };
 
 }  // namespace sdata
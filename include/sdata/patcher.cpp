@@ -0,0 +1,134 @@
+#include "patcher.hpp"
+#include "misc/trim.hpp"
+
+namespace sdata {
+
+Patcher::Patcher(std::string_view source) : m_source(source), m_skimmer(source), m_edits() {}
+
+Patcher &Patcher::set(std::string_view path, const Variant &value) {
+  SourceSpan span = locate(path);
+  Edit edit {span.value_begin, span.value_end, {}};
+
+  if ((m_source[span.value_begin] == '{') == value.is<Sequence>()) {
+    edit.text = trim(Writer(value, Format::inlined()).buffer(), ' ');
+  } else {
+    // Switch between the assigned and the sequence syntaxes
+    std::string_view id = path.substr(path.rfind('.') + 1);
+    Writer writer {Node::borrow(id, value), Format::inlined()};
+    edit = {span.begin, span.end, std::string {writer.buffer()}};
+  }
+
+  auto next = std::partition_point(m_edits.begin(), m_edits.end(), [&](const Edit &e) {
+    return e.begin < edit.begin;
+  });
+
+  if ((next != m_edits.end() && next->begin < edit.end) ||
+      (next != m_edits.begin() && std::prev(next)->end > edit.begin)) {
+    throw PatcherException {fmt("Member '{}' overlaps a patched member", path)};
+  }
+
+  m_edits.insert(next, std::move(edit));
+  return *this;
+}
+
+bool Patcher::is_in_place() const {
+  return std::all_of(m_edits.begin(), m_edits.end(), [](const Edit &edit) {
+    return edit.text.size() == edit.end - edit.begin;
+  });
+}
+
+std::string Patcher::apply() const {
+  std::string source {};
+  size_t n = 0;
+
+  for (const Edit &edit : m_edits) {
+    source.append(m_source, n, edit.begin - n);
+    source.append(edit.text);
+    n = edit.end;
+  }
+
+  source.append(m_source, n);
+  return source;
+}
+
+SourceSpan Patcher::locate(std::string_view path) const {
+  if (auto range = skim_member(path)) {
+    return *range;
+  }
+
+  // Reports the syntax errors the skimmer can't detect
+  Parser parser {m_source, {.spans = true}};
+  Node node = parser.parse();
+  const SourceSpan *span = &parser.span();
+
+  for (size_t begin = 0, end = 0; end != std::string_view::npos; begin = end + 1) {
+    end = path.find('.', begin);
+    std::string_view id = path.substr(begin, end - begin);
+    auto *sequence = node.get_ptr<Sequence>();
+    size_t i = 0;
+
+    while (sequence && i < sequence->size() && (*sequence)[i].id() != id) {
+      i++;
+    }
+
+    if (!sequence || i == sequence->size()) {
+      throw PatcherException {fmt("Member '{}' not found", path)};
+    }
+
+    Node member = std::move((*sequence)[i]);
+    node = std::move(member);
+    span = &span->children[i];
+  }
+
+  return {span->begin, span->end, span->value_begin, span->value_end};
+}
+
+std::optional<SourceSpan> Patcher::skim_member(std::string_view path) const {
+  size_t n = m_skimmer.skip_ignored(0);
+
+  // Named root
+  if (n < m_source.size() && m_source[n] != '{') {
+    n = m_skimmer.skip_ignored(m_skimmer.skip_word(n));
+  }
+
+  for (size_t begin = 0, end = 0; end != std::string_view::npos; begin = end + 1) {
+    end = path.find('.', begin);
+    std::string_view id = path.substr(begin, end - begin);
+
+    if (n >= m_source.size() || m_source[n] != '{') {
+      return std::nullopt;
+    }
+
+    while (true) {
+      size_t member = m_skimmer.skip_ignored(n + 1);
+
+      if ((n = m_skimmer.skip_node(member)) == Skimmer::npos) {
+        return std::nullopt;
+      }
+
+      // Only the first member with the id is patched, as with Node::at()
+      if (m_source.compare(member, id.size(), id) == 0 &&
+          Skimmer::is_delimiter(m_source[member + id.size()])) {
+        size_t value = m_skimmer.skip_ignored(member + id.size());
+
+        if (end == std::string_view::npos) {
+          if (m_source[value] == ':') {
+            value = m_skimmer.skip_ignored(value + 1);
+          }
+          return SourceSpan {member, n, value, n};
+        }
+
+        n = value;
+        break;
+      }
+
+      if ((n = m_skimmer.skip_ignored(n)) >= m_source.size() || m_source[n] != ',') {
+        return std::nullopt;
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+}  // namespace sdata
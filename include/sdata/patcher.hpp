@@ -0,0 +1,60 @@
+#ifndef SDATA_PATCHER_HPP
+#define SDATA_PATCHER_HPP
+
+#include "parser.hpp"
+#include "skimmer.hpp"
+#include "writer.hpp"
+
+namespace sdata {
+
+class PatcherException : public Exception {
+public:
+  PatcherException(std::string_view description) :
+    Exception(fmt("[sdata::PatcherException raised]: {}", description)) {}
+};
+
+struct Patch {
+  std::string_view path;
+  Variant value;
+};
+
+// Rewrites members in their original source, the rest of the text is kept byte for byte with its
+// comments and formatting. The members are located by the skimmer without parsing, the source is
+// only parsed with spans when the skimmer can't find a member, to report the syntax errors.
+class Patcher {
+public:
+  struct Edit {
+    size_t begin, end;
+    std::string text;
+  };
+
+  explicit Patcher(std::string_view source);
+
+  /// Replace the value of the member at the dotted path, relative to the root node, with the
+  /// inlined value. The whole member is rewritten when it switches to or from a sequence
+  Patcher &set(std::string_view path, const Variant &value);
+
+  /// Edits sorted by position
+  inline const std::vector<Edit> &edits() const {
+    return m_edits;
+  }
+
+  /// Check if every edit keeps the length of its range, the source can then be patched in place
+  bool is_in_place() const;
+
+  /// Patched copy of the source
+  std::string apply() const;
+
+private:
+  /// Span of the member at the path, without its children
+  SourceSpan locate(std::string_view path) const;
+  std::optional<SourceSpan> skim_member(std::string_view path) const;
+
+  std::string_view m_source;
+  Skimmer m_skimmer;
+  std::vector<Edit> m_edits;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,210 @@
+#include "path.hpp"
+#include <charconv>
+
+namespace sdata {
+
+/// Call the visitor with the values matched by the step in the value
+template<typename F>
+static void expand(const PathStep &step, const Variant &value, F &&visitor) {
+  const Sequence *sequence = value.get_ptr<Sequence>();
+  const Array *array = sequence ? nullptr : value.get_ptr<Array>();
+
+  switch (step.kind) {
+    case PathStep::MEMBER:
+      if (const Node *member = sequence ? sequence->find(step.id) : nullptr) {
+        visitor(*member);
+      }
+      break;
+
+    case PathStep::INDEX:
+      if (sequence && step.index < sequence->size()) {
+        visitor((*sequence)[step.index]);
+      } else if (array && step.index < array->size()) {
+        visitor((*array)[step.index]);
+      }
+      break;
+
+    case PathStep::WILDCARD:
+      if (sequence) {
+        for (const Node &member : *sequence) {
+          visitor(member);
+        }
+      } else if (array) {
+        for (const Variant &item : *array) {
+          visitor(item);
+        }
+      }
+      break;
+  }
+}
+
+Path::Path(std::string_view expression) : m_expression(expression) {
+  size_t n = 0;
+
+  while (n < expression.size()) {
+    PathStep step {};
+
+    if (expression[n] == '[') {
+      size_t end = expression.find(']', n);
+
+      if (end == std::string_view::npos) {
+        error("Expected ']'");
+      }
+
+      std::string_view index = expression.substr(n + 1, end - n - 1);
+
+      if (index == "*") {
+        step.kind = PathStep::WILDCARD;
+      } else {
+        auto [last, ec] = std::from_chars(index.data(), index.data() + index.size(), step.index);
+
+        if (ec != std::errc {} || last != index.data() + index.size() || index.empty()) {
+          error(fmt("Invalid index '{}'", index));
+        }
+        step.kind = PathStep::INDEX;
+      }
+
+      n = end + 1;
+    } else {
+      // Members follow the previous step after a dot
+      if (n > 0 && expression[n++] != '.') {
+        error("Expected '.' or '['");
+      }
+
+      size_t end = std::min(expression.find_first_of(".[", n), expression.size());
+      std::string_view id = expression.substr(n, end - n);
+
+      if (id == "*") {
+        step.kind = PathStep::WILDCARD;
+      } else if (is_identifier(id)) {
+        step.id = Atom {id};
+      } else {
+        error(fmt("Invalid member identifier '{}'", id));
+      }
+
+      n = end;
+    }
+
+    m_steps.push_back(step);
+  }
+}
+
+std::vector<const Variant *> Path::select(const Variant &root) const {
+  std::vector<const Variant *> matches {&root}, next {};
+
+  // Expanded step by step, each step keeps the document order
+  for (const PathStep &step : m_steps) {
+    next.clear();
+
+    for (const Variant *value : matches) {
+      expand(step, *value, [&next](const Variant &match) {
+        next.push_back(&match);
+      });
+    }
+
+    std::swap(matches, next);
+  }
+
+  return matches;
+}
+
+const Variant *Path::find(const Variant &root) const {
+  const Variant *value = &root;
+
+  for (size_t n = 0; n < m_steps.size(); n++) {
+    if (m_steps[n].kind == PathStep::WILDCARD) {
+      auto matches = select(root);
+      return matches.empty() ? nullptr : matches.front();
+    }
+
+    const Variant *match = nullptr;
+    expand(m_steps[n], *value, [&match](const Variant &child) {
+      match = &child;
+    });
+
+    if (!(value = match)) {
+      return nullptr;
+    }
+  }
+
+  return value;
+}
+
+Query::Query(const std::vector<std::string_view> &expressions) {
+  for (std::string_view expression : expressions) {
+    add(Path {expression});
+  }
+}
+
+size_t Query::add(const Path &path) {
+  size_t branch = 0;
+
+  for (const PathStep &step : path.steps()) {
+    auto &children = m_branches[branch].children;
+    auto child = std::find_if(children.begin(), children.end(), [&](size_t child) {
+      return m_branches[child].step == step;
+    });
+
+    if (child != children.end()) {
+      branch = *child;
+    } else {
+      children.push_back(m_branches.size());
+      branch = m_branches.size();
+      m_branches.push_back({step, {}, {}, 0});
+    }
+  }
+
+  m_branches[branch].paths.push_back(m_path_count);
+  return m_path_count++;
+}
+
+Query::Matches Query::evaluate(const Variant &root) {
+  Matches matches {};
+  evaluate(root, matches);
+  return matches;
+}
+
+void Query::evaluate(const Variant &root, Matches &matches) {
+  matches.resize(m_path_count);
+
+  for (auto &path_matches : matches) {
+    path_matches.clear();
+  }
+
+  follow(0, root, matches);
+}
+
+void Query::follow(size_t branch, const Variant &value, Matches &matches) {
+  for (size_t path : m_branches[branch].paths) {
+    matches[path].push_back(&value);
+  }
+
+  for (size_t child : m_branches[branch].children) {
+    const PathStep &step = m_branches[child].step;
+
+    if (step.kind != PathStep::MEMBER) {
+      expand(step, value, [&](const Variant &match) {
+        follow(child, match, matches);
+      });
+    } else if (const Sequence *sequence = value.get_ptr<Sequence>()) {
+      if (const Node *match = member(m_branches[child], *sequence)) {
+        follow(child, *match, matches);
+      }
+    }
+  }
+}
+
+const Node *Query::member(Branch &branch, const Sequence &sequence) {
+  if (branch.position < sequence.size() && sequence[branch.position].atom() == branch.step.id) {
+    return &sequence[branch.position];
+  }
+
+  const Node *member = sequence.find(branch.step.id);
+
+  if (member) {
+    branch.position = member - sequence.data();
+  }
+  return member;
+}
+
+}  // namespace sdata
@@ -0,0 +1,115 @@
+#ifndef SDATA_PATH_HPP
+#define SDATA_PATH_HPP
+
+#include "node.hpp"
+#include <string>
+#include <vector>
+
+namespace sdata {
+
+class PathException : public Exception {
+public:
+  PathException(std::string_view description, std::string_view expression) :
+    Exception(fmt("[sdata::PathException raised]: {} in path '{}'", description, expression)) {}
+};
+
+struct PathStep {
+  enum Kind {
+    /// First member with the identifier
+    MEMBER,
+    /// N-th item of an array or member of a sequence
+    INDEX,
+    /// Every item of an array or member of a sequence
+    WILDCARD,
+  };
+
+  Kind kind = MEMBER;
+  Atom id {};
+  size_t index = 0;
+
+  inline bool operator==(const PathStep &other) const = default;
+};
+
+// Path expression compiled once and evaluated on any number of trees. Member ids are separated
+// by dots, indices and wildcards are bracketed, relative to the root node: 'a.b[3].c', 'a.*.c',
+// 'a[*]'. The identifiers are interned at compilation, a member step is an atom lookup
+class Path {
+public:
+  explicit Path(std::string_view expression);
+
+  inline const std::string &expression() const {
+    return m_expression;
+  }
+
+  inline const std::vector<PathStep> &steps() const {
+    return m_steps;
+  }
+
+  /// Values matched by the path in document order
+  std::vector<const Variant *> select(const Variant &root) const;
+
+  /// First value matched by the path, nullptr if none
+  const Variant *find(const Variant &root) const;
+
+private:
+  [[noreturn]] void error(std::string_view description) const {
+    throw PathException {description, m_expression};
+  }
+
+  std::string m_expression;
+  std::vector<PathStep> m_steps;
+};
+
+// Batch of paths evaluated in a single traversal, the common prefixes are followed once. The
+// positions of the matched members are cached: while the documents keep their structure, the
+// evaluations check the cached positions instead of searching the sequences. Members are expected
+// to have distinct identifiers, as Node::insert() guarantees, a cached position may otherwise
+// match a later member of the same identifier.
+// The evaluations update the cache, a query can't be evaluated concurrently
+class Query {
+public:
+  using Matches = std::vector<std::vector<const Variant *>>;
+
+  Query() = default;
+  explicit Query(const std::vector<std::string_view> &expressions);
+
+  /// Add the path to the batch, returns the index of its matches
+  size_t add(const Path &path);
+
+  /// Paths count
+  inline size_t size() const {
+    return m_path_count;
+  }
+
+  /// Values matched by each path in document order, in the order of addition
+  Matches evaluate(const Variant &root);
+
+  /// Evaluate into the matches, their allocations are reused
+  void evaluate(const Variant &root, Matches &matches);
+
+private:
+  // Step of the paths trie
+  struct Branch {
+    PathStep step;
+    std::vector<size_t> children;
+
+    /// Paths ending with the step
+    std::vector<size_t> paths;
+
+    /// Position of the last member matched by a member step
+    size_t position = 0;
+  };
+
+  void follow(size_t branch, const Variant &value, Matches &matches);
+
+  /// Member matched by the member step, at its cached position if unchanged
+  const Node *member(Branch &branch, const Sequence &sequence);
+
+  /// Root branch first
+  std::vector<Branch> m_branches {Branch {}};
+  size_t m_path_count = 0;
+};
+
+}  // namespace sdata
+
+#endif
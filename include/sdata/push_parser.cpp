@@ -0,0 +1,162 @@
+#include "push_parser.hpp"
+
+namespace sdata {
+
+PushParser::PushParser(ParserOptions options) :
+  m_options(options),
+  m_buffer(),
+  m_ends(),
+  m_begin(0),
+  m_scan(0),
+  m_depth(0),
+  m_state(BLANK),
+  m_quote(0),
+  m_escape(false),
+  m_comment(false) {
+  // The buffer is reused once the nodes are parsed
+  m_options.borrow = false;
+  m_options.spans = false;
+}
+
+void PushParser::feed(std::string_view chunk) {
+  compact();
+  m_buffer.append(chunk);
+
+  for (; m_scan < m_buffer.size(); m_scan++) {
+    while (!scan(m_buffer[m_scan])) {
+    }
+  }
+}
+
+void PushParser::finish() {
+  // A word touching the end may be a complete node, the parser reports anything else
+  if (m_state != BLANK || m_comment) {
+    complete(m_buffer.size());
+  }
+
+  m_quote = 0;
+  m_escape = false;
+  m_comment = false;
+}
+
+std::optional<Node> PushParser::next() {
+  while (!m_ends.empty()) {
+    size_t end = m_ends.front();
+    size_t begin = std::exchange(m_begin, end);
+    m_ends.pop_front();
+
+    if (auto node = Parser(m_buffer, begin, end, m_options).parse_next()) {
+      return node;
+    }
+  }
+
+  return std::nullopt;
+}
+
+bool PushParser::scan(char c) {
+  if (m_comment) {
+    m_comment = c != '#';
+    return true;
+  }
+
+  if (m_quote) {
+    if (m_escape) {
+      m_escape = false;
+    } else if (c == '\\') {
+      m_escape = true;
+    } else if (c == m_quote) {
+      m_quote = 0;
+
+      if (m_state == STRING) {
+        complete(m_scan + 1);
+      }
+    }
+    return true;
+  }
+
+  switch (m_state) {
+    case BLANK:
+    case AFTER_ID:
+    case AFTER_SET: {
+      if (Skimmer::is_blank(c)) {
+        return true;
+      }
+
+      bool value = m_state == AFTER_SET;
+
+      if (c == '#') {
+        m_comment = true;
+      } else if ((c == '{' && !value) || (c == '[' && value)) {
+        m_state = CONTAINER;
+        m_depth = 1;
+      } else if ((c == '\'' || c == '"') && value) {
+        m_state = STRING;
+        m_quote = c;
+      } else if (c == ':' && m_state == AFTER_ID) {
+        m_state = AFTER_SET;
+      } else if (!Skimmer::is_delimiter(c) && m_state != AFTER_ID) {
+        m_state = value ? WORD : ID;
+      } else {
+        // Malformed node, the parser reports the error
+        complete(m_scan + 1);
+      }
+      return true;
+    }
+
+    case ID:
+    case WORD: {
+      if (!Skimmer::is_delimiter(c)) {
+        return true;
+      }
+
+      if (m_state == ID) {
+        m_state = AFTER_ID;
+      } else {
+        complete(m_scan);
+      }
+      return false;
+    }
+
+    case CONTAINER: {
+      switch (c) {
+        case '{':
+        case '[': m_depth++; break;
+
+        case '}':
+        case ']': {
+          if (--m_depth == 0) {
+            complete(m_scan + 1);
+          }
+        } break;
+
+        case '\'':
+        case '"': m_quote = c; break;
+
+        case '#': m_comment = true; break;
+      }
+      return true;
+    }
+
+    default: return true;
+  }
+}
+
+void PushParser::complete(size_t end) {
+  m_ends.push_back(end);
+  m_state = BLANK;
+}
+
+void PushParser::compact() {
+  if (m_begin > m_buffer.size() / 2) {
+    m_buffer.erase(0, m_begin);
+    m_scan -= m_begin;
+
+    for (size_t &end : m_ends) {
+      end -= m_begin;
+    }
+
+    m_begin = 0;
+  }
+}
+
+}  // namespace sdata
@@ -0,0 +1,59 @@
+#ifndef SDATA_PUSH_PARSER_HPP
+#define SDATA_PUSH_PARSER_HPP
+
+#include "parser.hpp"
+#include "skimmer.hpp"
+#include <deque>
+
+namespace sdata {
+
+// Parses top-level nodes from input pushed in chunks of any size, for sources that can't be
+// read by a blocking stream. The structural scan keeps its state between the chunks, so tokens
+// split mid-string or mid-number are resumed and every byte is scanned once. Only the pending
+// node is buffered, it is parsed as soon as it closes.
+class PushParser {
+public:
+  explicit PushParser(ParserOptions options = {});
+
+  /// Append the next chunk of the source
+  void feed(std::string_view chunk);
+
+  /// Mark the end of the source, a node still open is reported by next()
+  void finish();
+
+  /// Parse the next completed node, std::nullopt until more nodes are closed
+  std::optional<Node> next();
+
+private:
+  enum State {
+    BLANK,
+    ID,
+    AFTER_ID,
+    AFTER_SET,
+    WORD,
+    STRING,
+    CONTAINER,
+  };
+
+  /// Advance the scan state with the character, returns false to process it again
+  bool scan(char c);
+  void complete(size_t end);
+  void compact();
+
+  ParserOptions m_options;
+  std::string m_buffer;
+  std::deque<size_t> m_ends;
+  size_t m_begin;
+  size_t m_scan;
+  size_t m_depth;
+  State m_state;
+  char m_quote;
+
+  /// The next character of the string is escaped
+  bool m_escape;
+  bool m_comment;
+};
+
+}  // namespace sdata
+
+#endif
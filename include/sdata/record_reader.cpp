@@ -0,0 +1,78 @@
+#include "record_reader.hpp"
+
+namespace sdata {
+
+RecordReader::RecordReader(std::istream &stream, size_t block_size) :
+  m_stream(stream),
+  m_buffer(),
+  m_begin(0),
+  m_block_size(block_size) {}
+
+std::optional<Node> RecordReader::next() {
+  compact();
+
+  size_t end = skim_record(m_begin);
+  auto record = Parser(m_buffer, m_begin, end).parse_next();
+
+  m_begin = end;
+  return record;
+}
+
+std::vector<Node> RecordReader::next_batch(size_t count, size_t thread_count) {
+  compact();
+
+  size_t end = m_begin;
+
+  for (size_t i = 0; i < count && (end < m_buffer.size() || m_stream); i++) {
+    end = skim_record(end);
+  }
+
+  std::string_view batch {m_buffer.data() + m_begin, end - m_begin};
+  auto records = ParallelParser(batch, thread_count).parse_records();
+
+  m_begin = end;
+  return records;
+}
+
+size_t RecordReader::skim_record(size_t n) {
+  while (true) {
+    Skimmer skimmer {m_buffer};
+    size_t begin = skimmer.skip_ignored(n);
+    size_t end = begin < m_buffer.size() ? skimmer.skip_node(begin) : Skimmer::npos;
+
+    // A word touching the end of the buffer may continue in the next block
+    if (end < m_buffer.size()) {
+      return end;
+    }
+
+    // The parser reports the truncated record, if any
+    if (!read_block()) {
+      return m_buffer.size();
+    }
+  }
+}
+
+bool RecordReader::read_block() {
+  if (!m_stream) {
+    return false;
+  }
+
+  // Grow with the pending data so that huge records are skimmed a logarithmic number of times
+  size_t size = m_buffer.size();
+  size_t block_size = std::max(m_block_size, size - m_begin);
+
+  m_buffer.resize(size + block_size);
+  m_stream.read(m_buffer.data() + size, block_size);
+  m_buffer.resize(size + m_stream.gcount());
+
+  return m_stream.gcount() > 0;
+}
+
+void RecordReader::compact() {
+  if (m_begin > m_buffer.size() / 2) {
+    m_buffer.erase(0, m_begin);
+    m_begin = 0;
+  }
+}
+
+}  // namespace sdata
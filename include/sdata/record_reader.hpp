@@ -0,0 +1,35 @@
+#ifndef SDATA_RECORD_READER_HPP
+#define SDATA_RECORD_READER_HPP
+
+#include "parallel_parser.hpp"
+#include <istream>
+
+namespace sdata {
+
+// Reads the consecutive top-level nodes of a stream as independent records. The stream is
+// buffered by blocks, consumed records are dropped and the buffer is reused between records.
+class RecordReader {
+public:
+  explicit RecordReader(std::istream &stream, size_t block_size = 1 << 16);
+
+  /// Read the next record, std::nullopt at the end of the stream
+  std::optional<Node> next();
+
+  /// Read up to count records parsed concurrently, empty at the end of the stream
+  std::vector<Node> next_batch(size_t count, size_t thread_count = 0);
+
+private:
+  /// Find the end of the record beginning at n, the end of the buffer once the stream is exhausted
+  size_t skim_record(size_t n);
+  bool read_block();
+  void compact();
+
+  std::istream &m_stream;
+  std::string m_buffer;
+  size_t m_begin;
+  size_t m_block_size;
+};
+
+}  // namespace sdata
+
+#endif
@@ -2,32 +2,66 @@
 
 namespace sdata {
 
-Scanner::Scanner(std::string_view source) : m_source(source), m_iter(m_source.begin()) {}
+Scanner::Scanner(std::string_view source) : Scanner(source, 0, source.size()) {}
+
+Scanner::Scanner(std::string_view source, size_t begin, size_t end) :
+  m_source(source),
+  m_iter(m_source.begin() + begin),
+  m_end(m_source.begin() + end) {}
 
 Token Scanner::tokenize() {
-  Token token {{}, Token::NONE, {m_source, m_iter}};
+  Token token {};
 
-  if (done()) {
-    token.category = Token::DONE;
-    return token;
-  }
+  // Skip ignored tokens
+  do {
+    token = {{}, Token::NONE, {m_source, m_iter}};
+
+    if (done()) {
+      token.category = Token::DONE;
+      return token;
+    }
 
-  for (const auto &[category, pattern] : Token::PATTERN) {
-    if (auto match = pattern.match(m_iter, m_source.end())) {
-      token.expression = {m_iter, m_iter += match.length};
-      token.category = category;
+    // An escaped quote doesn't close the string, which the pattern can't express
+    if (size_t length = quoted_length()) {
+      auto end = m_iter + length;
+      token.expression = {m_iter, end};
+      m_iter = end;
+      token.category = Token::STRING;
       break;
     }
-  }
 
-  if (token.category & Token::NONE) {
-    // Token unrecognized by scanner, split the token by space
-    token.expression = {m_iter, std::find(m_iter, m_source.end(), ' ')};
-    throw ScannerException {"Unrecognized token", token};
+    for (const auto &[category, pattern] : Token::PATTERN) {
+      if (auto match = pattern.match(m_iter, m_end)) {
+        auto end = m_iter + match.length;
+        token.expression = {m_iter, end};
+        m_iter = end;
+        token.category = category;
+        break;
+      }
+    }
+
+    // The optional float suffix is never matched by the pattern, whose empty branch comes first
+    if (token.category == Token::FLOAT && m_iter != m_end && *m_iter == 'f') {
+      token.expression = {token.expression.begin(), ++m_iter};
+    }
+
+    if (token.category & Token::NONE) {
+      // Token unrecognized by scanner, split the token by space
+      token.expression = {m_iter, std::find(m_iter, m_end, ' ')};
+      throw ScannerException {"Unrecognized token", token};
+    }
+  } while (token.category & Token::IGNORED);
+
+  return token;
+}
+
+size_t Scanner::quoted_length() const {
+  if (*m_iter != '\'' && *m_iter != '"') {
+    return 0;
   }
 
-  // Skip ignored tokens
-  return !(token.category & Token::IGNORED) ? token : tokenize();
+  size_t end = closing_quote({m_iter, m_end}, 0);
+  return end != std::string_view::npos ? end + 1 : 0;
 }
 
 }  // namespace sdata
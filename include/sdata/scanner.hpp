@@ -2,6 +2,7 @@
 #define SDATA_SCANNER_HPP
 
 #include "misc/code_exception.hpp"
+#include "misc/escaped.hpp"
 #include "token.hpp"
 
 namespace sdata {
@@ -16,6 +17,9 @@ class Scanner {
 public:
   Scanner(std::string_view source);
 
+  /// Scanner restricted to the [begin, end) range of the source
+  Scanner(std::string_view source, size_t begin, size_t end);
+
   Token tokenize();
 
   inline std::string_view source() const {
@@ -23,12 +27,30 @@ public:
   }
 
   inline bool done() const {
-    return m_iter == m_source.end();
+    return m_iter == m_end;
+  }
+
+  /// Offset of the next character to scan in the source
+  inline size_t position() const {
+    return m_iter - m_source.begin();
+  }
+
+  /// Offset of the end of the scanned range
+  inline size_t end() const {
+    return m_end - m_source.begin();
+  }
+
+  /// Resume the scanning at the offset, the characters in between are consumed by the caller
+  inline void seek(size_t position) {
+    m_iter = m_source.begin() + position;
   }
 
 private:
+  /// Length of the quoted string at the scanned position, zero if none or unterminated
+  size_t quoted_length() const;
+
   std::string_view m_source;
-  std::string_view::iterator m_iter;
+  std::string_view::iterator m_iter, m_end;
 };
 
 }  // namespace sdata
@@ -1,8 +1,18 @@
 #ifndef SDATA_HPP
 #define SDATA_HPP
 
-#include "misc/escaped.hpp"
+#include "constant.hpp"
+#include "document.hpp"
+#include "extractor.hpp"
+#include "frozen.hpp"
+#include "node_builder.hpp"
+#include "parallel_parser.hpp"
 #include "parser.hpp"
+#include "patcher.hpp"
+#include "path.hpp"
+#include "push_parser.hpp"
+#include "record_reader.hpp"
+#include "traversal.hpp"
 #include "writer.hpp"
 #include <filesystem>
 #include <fstream>
@@ -16,19 +26,58 @@ static std::string read_file(std::filesystem::path path) {
     throw Exception {fmt("Can't read source from: '{}'", path.string())};
   }
 
-  std::stringstream sstream {};
-  sstream << Escaped {fstream};
-  return sstream.str();
+  // Escape sequences are decoded by the parser, the file is read as is
+  std::string source {};
+  fstream.seekg(0, std::ios::end);
+  source.resize(fstream.tellg());
+  fstream.seekg(0, std::ios::beg);
+  fstream.read(source.data(), source.size());
+  source.resize(fstream.gcount());
+
+  return source;
 }
 
-inline Node parse_str(std::string_view source) {
-  return Parser(source).parse();
+inline Node parse_str(std::string_view source, ParserOptions options = {}) {
+  return Parser(source, options).parse();
 }
 
 inline Node parse_file(std::filesystem::path path) {
   return parse_str(read_file(path));
 }
 
+/// Extract the members on the dotted paths into a pruned tree, skipping the rest of the source
+inline Node extract(std::string_view source, const std::vector<std::string_view> &paths) {
+  return Extractor(source, paths).extract();
+}
+
+/// Parse the root members concurrently, the resulting tree is identical to parse_str()
+inline Node parse_parallel(std::string_view source, size_t thread_count = 0) {
+  return ParallelParser(source, thread_count).parse();
+}
+
+/// Parse every top-level node of the source as a record, concurrently with multiple threads
+inline std::vector<Node> parse_records(std::string_view source, size_t thread_count = 0) {
+  return ParallelParser(source, thread_count).parse_records();
+}
+
+/// Read-only copy of the tree in a single block, for the documents loaded once and read often
+inline Frozen freeze(const Node &node) {
+  return Frozen {node};
+}
+
+/// Parse the source over an existing tree, reusing its allocations when the shapes match
+inline void parse_into(std::string_view source, Node &node) {
+  Parser(source).parse_into(node);
+}
+
+/// Deserialize the root node of the source without building the node tree.
+/// Schemed std::string_view properties reference the source, which must outlive the object,
+/// escaped strings can only be deserialized into std::string properties
+template<typename T>
+requires(is_serialized<T>) inline void parse_into(std::string_view source, T &object) {
+  Parser(source).parse_into(object);
+}
+
 inline std::string write_str(const Node &node, Format format = Format::standard()) {
   return std::string {Writer(node, format).buffer()};
 }
@@ -39,6 +88,40 @@ write_file(std::filesystem::path path, const Node &node, Format format = Format:
   fstream << Writer(node, format).buffer();
 }
 
+/// Rewrite the members at the dotted paths, the rest of the source is kept as is
+inline std::string patch_str(std::string_view source, const std::vector<Patch> &patches) {
+  Patcher patcher {source};
+
+  for (const Patch &patch : patches) {
+    patcher.set(patch.path, patch.value);
+  }
+
+  return patcher.apply();
+}
+
+/// Rewrite the members at the dotted paths of the file, only the edited bytes are written when
+/// the patched members keep their length
+inline void patch_file(std::filesystem::path path, const std::vector<Patch> &patches) {
+  std::string source = read_file(path);
+  Patcher patcher {source};
+
+  for (const Patch &patch : patches) {
+    patcher.set(patch.path, patch.value);
+  }
+
+  if (!patcher.is_in_place()) {
+    std::ofstream {path, std::ios::out | std::ios::binary} << patcher.apply();
+    return;
+  }
+
+  std::fstream fstream {path, std::ios::in | std::ios::out | std::ios::binary};
+
+  for (const auto &edit : patcher.edits()) {
+    fstream.seekp(edit.begin);
+    fstream.write(edit.text.data(), edit.text.size());
+  }
+}
+
 template<typename T>
 inline void encode(Node &node, const T &object) {
   Serializer<T>().encode(node, object);
@@ -53,8 +136,11 @@ inline void decode(const Node &node, T &object) {
 
 namespace sdata::literals {
 
-inline Node operator""_sdata(const char *source, size_t) {
-  return parse_str(source);
+/// Literal parsed at compile time into a static read-only tree, syntax errors fail the
+/// compilation. Converts to a Node borrowing the constant identifiers and strings
+template<Literal S>
+consteval ConstantNode operator""_sdata() {
+  return ConstantTree<S>::root();
 }
 
 }  // namespace sdata::literals
@@ -0,0 +1,107 @@
+#include "skimmer.hpp"
+#include "misc/escaped.hpp"
+
+namespace sdata {
+
+size_t Skimmer::skip_ignored(size_t n) const {
+  while (n < m_source.size()) {
+    if (m_source[n] == '#') {
+      if ((n = m_source.find('#', n + 1)) == npos) {
+        return npos;
+      }
+      n++;
+    } else if (is_blank(m_source[n])) {
+      n++;
+    } else {
+      break;
+    }
+  }
+
+  return n;
+}
+
+size_t Skimmer::skip_word(size_t n) const {
+  size_t begin = n;
+
+  while (n < m_source.size() && !is_delimiter(m_source[n])) {
+    n++;
+  }
+
+  return n != begin ? n : npos;
+}
+
+size_t Skimmer::skip_string(size_t n) const {
+  size_t end = closing_quote(m_source, n);
+  return end != npos ? end + 1 : npos;
+}
+
+size_t Skimmer::skip_container(size_t n) const {
+  size_t depth = 0;
+
+  while (n < m_source.size()) {
+    switch (m_source[n]) {
+      case '{':
+      case '[': depth++, n++; break;
+
+      case '}':
+      case ']': {
+        if (n++, --depth == 0) {
+          return n;
+        }
+      } break;
+
+      case '\'':
+      case '"': {
+        if ((n = skip_string(n)) == npos) {
+          return npos;
+        }
+      } break;
+
+      case '#': {
+        if ((n = skip_ignored(n)) == npos) {
+          return npos;
+        }
+      } break;
+
+      default: n++; break;
+    }
+  }
+
+  return npos;
+}
+
+size_t Skimmer::skip_variant(size_t n) const {
+  if ((n = skip_ignored(n)) >= m_source.size()) {
+    return npos;
+  }
+
+  switch (m_source[n]) {
+    case '[': return skip_container(n);
+    case '\'':
+    case '"': return skip_string(n);
+    default: return skip_word(n);
+  }
+}
+
+size_t Skimmer::skip_node(size_t n) const {
+  if ((n = skip_ignored(n)) >= m_source.size()) {
+    return npos;
+  }
+
+  // Anonymous node
+  if (m_source[n] == '{') {
+    return skip_container(n);
+  }
+
+  if ((n = skip_word(n)) == npos || (n = skip_ignored(n)) >= m_source.size()) {
+    return npos;
+  }
+
+  switch (m_source[n]) {
+    case '{': return skip_container(n);
+    case ':': return skip_variant(n + 1);
+    default: return npos;
+  }
+}
+
+}  // namespace sdata
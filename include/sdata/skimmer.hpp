@@ -0,0 +1,73 @@
+#ifndef SDATA_SKIMMER_HPP
+#define SDATA_SKIMMER_HPP
+
+#include <array>
+#include <string_view>
+
+namespace sdata {
+
+// Character-level structural scan of the source, used to find node boundaries without tokenizing.
+// The skimmer trusts the source: malformed input yields wrong boundaries or npos, the parser is
+// responsible for reporting the syntax errors.
+class Skimmer {
+public:
+  constexpr static size_t npos = std::string_view::npos;
+
+  explicit Skimmer(std::string_view source) : m_source(source) {}
+
+  inline std::string_view source() const {
+    return m_source;
+  }
+
+  /// Skip the blanks and the comments
+  size_t skip_ignored(size_t n) const;
+
+  /// Skip an identifier or a scalar expression
+  size_t skip_word(size_t n) const;
+
+  /// Skip a quoted string
+  size_t skip_string(size_t n) const;
+
+  /// Skip a sequence or an array with its nested content
+  size_t skip_container(size_t n) const;
+
+  /// Skip a variant value
+  size_t skip_variant(size_t n) const;
+
+  /// Skip a named or anonymous node
+  size_t skip_node(size_t n) const;
+
+  constexpr static bool is_blank(char c) {
+    return CHARACTERS[static_cast<unsigned char>(c)] == BLANK;
+  }
+
+  constexpr static bool is_delimiter(char c) {
+    return CHARACTERS[static_cast<unsigned char>(c)] != WORD;
+  }
+
+private:
+  enum Character : char {
+    WORD,
+    BLANK,
+    OPERATOR,
+  };
+
+  constexpr static std::array<Character, 256> CHARACTERS = [] {
+    std::array<Character, 256> characters {};
+
+    for (char c : std::string_view {"\n\t\v\b\f "}) {
+      characters[static_cast<unsigned char>(c)] = BLANK;
+    }
+    for (char c : std::string_view {",:{}[]#'\""}) {
+      characters[static_cast<unsigned char>(c)] = OPERATOR;
+    }
+
+    return characters;
+  }();
+
+  std::string_view m_source;
+};
+
+}  // namespace sdata
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef SDATA_STRING_HPP
+#define SDATA_STRING_HPP
+
+#include "misc/escaped.hpp"
+#include <fmt/format.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace sdata {
+
+// Variant string data of 15 bytes, stored inline up to INLINE_CAPACITY characters, on the heap
+// or borrowed from a source that outlives it otherwise. Borrowed escaped strings are decoded into
+// owned data on their first access, concurrent readers of such a string must synchronize. The
+// strings of the boxes shared by the variant copies are decoded before, see Variant::share()
+class String {
+  enum Mode : uint8_t {
+    INLINE,
+    OWNED,
+    BORROWED,
+    ESCAPED,
+  };
+
+  /// The last byte holds the mode and the inline size, the others the inline characters or the
+  /// external data pointer and its 32 bits size. Owned data is preceded by its 32 bits capacity
+  constexpr static size_t TAG = 14, SIZE = 8, HEADER = sizeof(uint32_t);
+
+public:
+  constexpr static size_t INLINE_CAPACITY = TAG;
+
+  String() : m_bytes() {}
+
+  explicit String(std::string_view view) : m_bytes() {
+    assign(view);
+  }
+
+  explicit String(const std::string &owned) : String(std::string_view {owned}) {}
+
+  explicit String(const char *data) : String(std::string_view {data}) {}
+
+  String(const String &other) : String() {
+    if (other.mode() == OWNED) {
+      assign(other.view());
+    } else {
+      std::memcpy(m_bytes, other.m_bytes, sizeof(m_bytes));
+    }
+  }
+
+  String(String &&other) noexcept : String() {
+    std::memcpy(m_bytes, other.m_bytes, sizeof(m_bytes));
+    other.m_bytes[TAG] = 0;
+  }
+
+  String &operator=(const String &other) {
+    if (this != &other) {
+      *this = String {other};
+    }
+    return *this;
+  }
+
+  String &operator=(String &&other) noexcept {
+    if (this != &other) {
+      release();
+      std::memcpy(m_bytes, other.m_bytes, sizeof(m_bytes));
+      other.m_bytes[TAG] = 0;
+    }
+    return *this;
+  }
+
+  ~String() {
+    release();
+  }
+
+  /// String referencing the view without copying, the viewed data must outlive the string
+  static String borrow(std::string_view view) {
+    String string {};
+    string.set_external(BORROWED, view);
+    return string;
+  }
+
+  /// String referencing escaped data, decoded on the first access
+  static String borrow_escaped(std::string_view view) {
+    String string {};
+    string.set_external(ESCAPED, view);
+    return string;
+  }
+
+  inline bool is_borrowed() const {
+    return mode() == BORROWED || mode() == ESCAPED;
+  }
+
+  inline std::string_view view() const {
+    if (mode() == ESCAPED) {
+      const_cast<String *>(this)->decode();
+    }
+    return mode() == INLINE ? std::string_view {m_bytes, static_cast<size_t>(m_bytes[TAG])}
+                            : std::string_view {external(), external_size()};
+  }
+
+  inline operator std::string_view() const {
+    return view();
+  }
+
+  inline std::string str() const {
+    return std::string {view()};
+  }
+
+  inline operator std::string() const {
+    return str();
+  }
+
+  /// Replace the content with a copy of the view, the owned buffer is reused
+  inline String &assign(std::string_view view) {
+    if (view.size() <= INLINE_CAPACITY) {
+      char characters[INLINE_CAPACITY];
+      std::memcpy(characters, view.data(), view.size());
+      release();
+      std::memcpy(m_bytes, characters, view.size());
+      m_bytes[TAG] = static_cast<char>(view.size());
+    } else {
+      char *data = reserve(view.size());
+      std::memmove(data, view.data(), view.size());
+      adopt(data, view.size());
+    }
+    return *this;
+  }
+
+  /// Replace the content with the decoded escaped view, the owned buffer is reused
+  inline String &assign_escaped(std::string_view view) {
+    if (view.size() <= INLINE_CAPACITY) {
+      char characters[INLINE_CAPACITY];
+      size_t size = unescape(view, characters);
+      release();
+      std::memcpy(m_bytes, characters, size);
+      m_bytes[TAG] = static_cast<char>(size);
+    } else {
+      // Decoding never grows the data, it's done in place if the view is the owned buffer
+      char *data = reserve(view.size());
+      adopt(data, unescape(view, data));
+    }
+    return *this;
+  }
+
+  /// Copy the borrowed data, the string no longer depends on its source
+  inline void own() {
+    if (mode() == BORROWED) {
+      assign(view());
+    } else {
+      decode();
+    }
+  }
+
+  /// Decode the escaped data ahead of the first access, the other data is kept
+  inline void decode() {
+    if (mode() == ESCAPED) {
+      assign_escaped({external(), external_size()});
+    }
+  }
+
+  inline const char *data() const {
+    return view().data();
+  }
+
+  inline size_t size() const {
+    return view().size();
+  }
+
+  inline bool empty() const {
+    return view().empty();
+  }
+
+  inline auto begin() const {
+    return view().begin();
+  }
+
+  inline auto end() const {
+    return view().end();
+  }
+
+  inline bool operator==(const String &other) const {
+    return view() == other.view();
+  }
+
+  inline bool operator==(std::string_view other) const {
+    return view() == other;
+  }
+
+private:
+  inline Mode mode() const {
+    return static_cast<Mode>(static_cast<uint8_t>(m_bytes[TAG]) >> 4);
+  }
+
+  inline const char *external() const {
+    const char *data;
+    std::memcpy(&data, m_bytes, sizeof(data));
+    return data;
+  }
+
+  inline size_t external_size() const {
+    uint32_t size;
+    std::memcpy(&size, m_bytes + SIZE, sizeof(size));
+    return size;
+  }
+
+  inline size_t capacity() const {
+    uint32_t capacity;
+    std::memcpy(&capacity, external() - HEADER, sizeof(capacity));
+    return capacity;
+  }
+
+  inline void set_external(Mode mode, std::string_view view) {
+    if (view.size() > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error {"sdata::String size exceeds 32 bits"};
+    }
+
+    const char *data = view.data();
+    auto size = static_cast<uint32_t>(view.size());
+    std::memcpy(m_bytes, &data, sizeof(data));
+    std::memcpy(m_bytes + SIZE, &size, sizeof(size));
+    m_bytes[TAG] = static_cast<char>(mode << 4);
+  }
+
+  /// Owned buffer of at least size characters, the current one if large enough
+  inline char *reserve(size_t size) {
+    if (mode() == OWNED && capacity() >= size) {
+      return const_cast<char *>(external());
+    }
+
+    if (size > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error {"sdata::String size exceeds 32 bits"};
+    }
+
+    auto capacity = static_cast<uint32_t>(size);
+    char *block = new char[HEADER + size];
+    std::memcpy(block, &capacity, sizeof(capacity));
+    return block + HEADER;
+  }
+
+  /// Replace the content with an owned buffer, the previous one is released if different
+  inline void adopt(char *data, size_t size) {
+    if (mode() != OWNED || data != external()) {
+      release();
+    }
+    set_external(OWNED, {data, size});
+  }
+
+  inline void release() {
+    if (mode() == OWNED) {
+      const char *block = external() - HEADER;
+      delete[] block;
+    }
+    m_bytes[TAG] = 0;
+  }
+
+  mutable char m_bytes[TAG + 1];
+};
+
+}  // namespace sdata
+
+template<>
+struct fmt::formatter<sdata::String> : fmt::formatter<std::string_view> {
+  template<typename F>
+  auto format(const sdata::String &string, F &context) {
+    return fmt::formatter<std::string_view>::format(string.view(), context);
+  }
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "misc/any_of.hpp"
 #include "serializer.hpp"
+#include "string.hpp"
 #include <iostream>
 
 namespace sdata {
@@ -51,7 +52,7 @@ requires(std::same_as<T, bool>) struct _Traits<T> {
 };
 
 template<typename T>
-requires(any_of<T, std::string, std::string_view, const char *, char *>) struct _Traits<T> {
+requires(any_of<T, String, std::string, std::string_view, const char *, char *>) struct _Traits<T> {
   constexpr static std::size_t index = Type::STRING;
 };
 
@@ -0,0 +1,60 @@
+#include "traversal.hpp"
+
+namespace sdata {
+
+Traversal &Traversal::start(const Node &root, Order order) {
+  m_order = order;
+  m_pending.clear();
+  m_front = 0;
+  m_current = {&root, root.id(), 0, 0};
+  m_is_done = false;
+  return *this;
+}
+
+void Traversal::next() {
+  if (m_is_done) {
+    return;
+  }
+
+  size_t depth = m_current.depth + 1;
+
+  auto push = [&](const auto &children, auto id) {
+    if (m_order == DEPTH_FIRST) {
+      // Reversed on the stack, the first child is popped first
+      for (size_t n = children.size(); n-- > 0;) {
+        m_pending.push_back({&children[n], id(children[n]), n, depth});
+      }
+    } else {
+      for (size_t n = 0; n < children.size(); n++) {
+        m_pending.push_back({&children[n], id(children[n]), n, depth});
+      }
+    }
+  };
+
+  if (const Sequence *sequence = m_current.value->get_ptr<Sequence>()) {
+    push(*sequence, [](const Node &member) {
+      return member.id();
+    });
+  } else if (const Array *array = m_current.value->get_ptr<Array>()) {
+    push(*array, [](const Variant &) {
+      return std::string_view {};
+    });
+  }
+
+  if (m_front == m_pending.size()) {
+    m_is_done = true;
+  } else if (m_order == DEPTH_FIRST) {
+    m_current = m_pending.back();
+    m_pending.pop_back();
+  } else {
+    m_current = m_pending[m_front++];
+  }
+
+  // The consumed entries are dropped once they are half of the queue, keeping it to the frontier
+  if (m_front * 2 >= m_pending.size()) {
+    m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<ptrdiff_t>(m_front));
+    m_front = 0;
+  }
+}
+
+}  // namespace sdata
@@ -0,0 +1,125 @@
+#ifndef SDATA_TRAVERSAL_HPP
+#define SDATA_TRAVERSAL_HPP
+
+#include "node.hpp"
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace sdata {
+
+// Value reached by a traversal
+struct Visited {
+  const Variant *value = nullptr;
+
+  /// Identifier of a member, empty for the array items and the anonymous members
+  std::string_view id {};
+
+  /// Position in the parent container and distance to the root
+  size_t index = 0, depth = 0;
+};
+
+// Non-recursive traversal of a node tree, depth-first in pre-order or breadth-first, the root
+// first. The pending values are kept in an explicit stack, reused by the next traversals of the
+// same object, so deep trees don't overflow the call stack. Iterated as a range or visited with
+// a visitor overloaded on the alternatives. The items of packed arrays are read from their generic
+// copy, see PackedArray::generic()
+class Traversal {
+public:
+  enum Order {
+    DEPTH_FIRST,
+    BREADTH_FIRST,
+  };
+
+  class Iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Visited;
+
+    Iterator() = default;
+    explicit Iterator(Traversal *traversal) : m_traversal(traversal) {}
+
+    inline const Visited &operator*() const {
+      return m_traversal->m_current;
+    }
+
+    inline const Visited *operator->() const {
+      return &m_traversal->m_current;
+    }
+
+    inline Iterator &operator++() {
+      m_traversal->next();
+      return *this;
+    }
+
+    inline void operator++(int) {
+      m_traversal->next();
+    }
+
+    inline bool operator==(std::default_sentinel_t) const {
+      return m_traversal->m_is_done;
+    }
+
+  private:
+    Traversal *m_traversal = nullptr;
+  };
+
+  Traversal() = default;
+
+  explicit Traversal(const Node &root, Order order = DEPTH_FIRST) {
+    start(root, order);
+  }
+
+  /// Restart the traversal from the root, the stack allocation is reused
+  Traversal &start(const Node &root, Order order = DEPTH_FIRST);
+
+  inline Iterator begin() {
+    return Iterator {this};
+  }
+
+  inline std::default_sentinel_t end() {
+    return {};
+  }
+
+  /// Call the visitor with the visited position and the alternative reference of each value.
+  /// A visitor returning false stops the traversal, returns false if it was stopped
+  template<typename F>
+  bool visit(const Node &root, F &&visitor, Order order = DEPTH_FIRST) {
+    for (start(root, order); !m_is_done; next()) {
+      bool is_continued = m_current.value->visit([&]<typename A>(const A &value) {
+        const Visited &visited = m_current;
+
+        if constexpr (std::same_as<std::invoke_result_t<F, const Visited &, const A &>, bool>) {
+          return visitor(visited, value);
+        } else {
+          visitor(visited, value);
+          return true;
+        }
+      });
+
+      if (!is_continued) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  /// Move to the next value, the children of the current one are pending
+  void next();
+
+  Order m_order = DEPTH_FIRST;
+
+  /// Stack of the depth-first traversals, queue from m_front of the breadth-first ones
+  std::vector<Visited> m_pending {};
+  size_t m_front = 0;
+
+  Visited m_current {};
+  bool m_is_done = true;
+};
+
+}  // namespace sdata
+
+#endif
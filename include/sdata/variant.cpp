@@ -2,6 +2,7 @@
 #include "misc/any_of.hpp"
 #include "node.hpp"
 #include "writer.hpp"
+#include <bit>
 
 namespace sdata {
 
@@ -19,18 +20,506 @@ std::string VariantException::message(std::string_view description, const Varian
   return fmt(PATTERN, description, variant->type(), Writer(*variant, Format::inlined()).buffer());
 }
 
+PackedArray::PackedArray(Type type, const Array &array) {
+  auto pack = [this, &array]<typename T>(std::in_place_type_t<T>) {
+    auto &items = m_items.emplace<Packed<T>>();
+    items.reserve(array.size());
+
+    for (const Variant &item : array) {
+      items.push_back(item.get<T>());
+    }
+  };
+
+  switch (type) {
+    case INT: pack(std::in_place_type<int>); break;
+    case FLOAT: pack(std::in_place_type<float>); break;
+    case BOOL: pack(std::in_place_type<bool>); break;
+    default: pack(std::in_place_type<String>);
+  }
+}
+
+PackedArray::PackedArray(const PackedArray &other) : m_items(other.m_items) {}
+
+PackedArray::~PackedArray() {
+  delete m_generic.load(std::memory_order_relaxed);
+}
+
+const Array &PackedArray::generic() const {
+  Array *generic = m_generic.load(std::memory_order_acquire);
+
+  if (!generic) {
+    auto *built = new Array(unpack());
+
+    if (m_generic.compare_exchange_strong(generic, built, std::memory_order_acq_rel)) {
+      generic = built;
+    } else {
+      delete built;
+    }
+  }
+
+  return *generic;
+}
+
+void PackedArray::invalidate() {
+  delete m_generic.exchange(nullptr, std::memory_order_relaxed);
+}
+
+Array PackedArray::unpack() const {
+  Array array {};
+  array.reserve(size());
+
+  visit([&array](auto items) {
+    array.insert(array.end(), items.begin(), items.end());
+  });
+
+  return array;
+}
+
+Variant::Variant(const Variant &other) : m_type(other.m_type) {
+  switch (type()) {
+    case ARRAY: {
+      if (other.is_packed()) {
+        share_box<PackedArray>(other);
+      } else {
+        share_box<Array>(other);
+      }
+      break;
+    }
+
+    case SEQUENCE: share_box<Sequence>(other); break;
+    case STRING: new (m_storage) String(*other.pointer<String>()); break;
+    default: std::memcpy(m_storage, other.m_storage, sizeof(m_storage));
+  }
+}
+
+bool Variant::pack() {
+  if (!is<Array>() || is_packed()) {
+    return is_packed();
+  }
+
+  const Array &array = box<Array>()->value;
+  Type type = array.empty() ? NIL : array[0].type();
+
+  if (type != INT && type != FLOAT && type != BOOL && type != STRING) {
+    return false;
+  }
+
+  auto is_homogeneous = [type](const Variant &item) {
+    return item.type() == type;
+  };
+
+  if (!std::all_of(array.begin(), array.end(), is_homogeneous)) {
+    return false;
+  }
+
+  auto *packed = new Box<PackedArray>(type, array);
+  reset();
+  store(packed);
+  m_type = ARRAY;
+  return true;
+}
+
+void Variant::push_back(Variant item) {
+  if (!is_packed() || item.type() != packed()->type()) {
+    get<Array>().push_back(std::move(item));
+    return;
+  }
+
+  PackedArray &packed = *pointer<PackedArray>();
+
+  switch (item.type()) {
+    case INT: return packed.items<int>().push_back(item.get<int>());
+    case FLOAT: return packed.items<float>().push_back(item.get<float>());
+    case BOOL: return packed.items<bool>().push_back(item.get<bool>());
+    default: return packed.items<String>().push_back(std::move(item.get<String>()));
+  }
+}
+
+// Nested containers of the boxes released by the thread, owned and destroyed one at a time by the
+// outermost release so that deep trees don't recurse
+thread_local std::vector<Variant> *released = nullptr;
+
+template<typename A>
+void release(A *box) {
+  if (box->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  std::vector<Variant> nested {};
+  bool is_outermost = !released;
+
+  if (is_outermost) {
+    released = &nested;
+  }
+
+  using Value = decltype(box->value);
+
+  if constexpr (any_of<Value, Array, Sequence>) {
+    for (Variant &child : box->value) {
+      if (child.is<Array>() || child.is<Sequence>()) {
+        released->push_back(std::move(child));
+      }
+    }
+  }
+
+  delete box;
+
+  if (is_outermost) {
+    while (!nested.empty()) {
+      Variant variant = std::move(nested.back());
+      nested.pop_back();
+    }
+
+    released = nullptr;
+  }
+}
+
+void Variant::decode_strings(Array &array) {
+  for (Variant &item : array) {
+    if (item.m_type == STRING) {
+      item.pointer<String>()->decode();
+    }
+  }
+}
+
+void Variant::decode_strings(Sequence &sequence) {
+  for (Variant &member : sequence) {
+    if (member.m_type == STRING) {
+      member.pointer<String>()->decode();
+    }
+  }
+}
+
+void Variant::decode_strings(PackedArray &packed) {
+  if (packed.type() == STRING) {
+    for (String &item : packed.items<String>().span()) {
+      item.decode();
+    }
+  }
+}
+
+template<typename A>
+void Variant::share_box(const Variant &other) {
+  Box<A> *box = other.box<A>();
+
+  if (box->is_leaked) {
+    box = new Box<A>(box->value);
+  } else {
+    box->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  store(box);
+}
+
+void Variant::share() {
+  // Nested leaked containers, visited without recursion
+  std::vector<Variant *> pending {};
+
+  auto share_children = [&pending](auto *box, auto &&children) {
+    if (box->is_leaked) {
+      box->is_leaked = false;
+      decode_strings(children);
+
+      for (Variant &child : children) {
+        if (child.is_leaked()) {
+          pending.push_back(&child);
+        }
+      }
+    }
+  };
+
+  for (Variant *variant = this;;) {
+    if (variant->is_packed()) {
+      auto *packed = variant->box<PackedArray>();
+
+      if (packed->is_leaked) {
+        packed->is_leaked = false;
+        decode_strings(packed->value);
+      }
+    } else if (variant->type() == ARRAY) {
+      share_children(variant->box<Array>(), variant->box<Array>()->value);
+    } else if (variant->type() == SEQUENCE) {
+      share_children(variant->box<Sequence>(), variant->box<Sequence>()->value);
+    }
+
+    if (pending.empty()) {
+      return;
+    }
+
+    variant = pending.back();
+    pending.pop_back();
+  }
+}
+
+/// Hash of a scalar, the items of the packed and generic arrays hash alike
+template<typename A>
+static uint64_t hash_scalar(const A &value) {
+  uint64_t hash = 0;
+
+  if constexpr (std::same_as<A, String>) {
+    hash = std::hash<std::string_view> {}(value.view());
+  } else if constexpr (std::same_as<A, float>) {
+    // 0.0 and -0.0 compare equal
+    hash = value == 0 ? 0 : std::bit_cast<uint32_t>(value);
+  } else if constexpr (!std::same_as<A, std::nullptr_t>) {
+    hash = static_cast<uint64_t>(value);
+  }
+
+  // Zero is the empty cache
+  hash = hash_combine(Traits<A>::index, hash);
+  return hash + (hash == 0);
+}
+
+uint64_t Variant::hash() const {
+  if (uint64_t hash = flat_hash()) {
+    return hash;
+  }
+
+  // Containers being hashed, each child is combined once hashed
+  struct Frame {
+    const Variant *container;
+    size_t next;
+    uint64_t hash;
+  };
+
+  std::vector<Frame> stack {{this, 0, type()}};
+
+  auto combine = [](Frame &frame, uint64_t hash) {
+    // The members hash as Node::hash()
+    if (const Sequence *sequence = frame.container->get_ptr<Sequence>()) {
+      std::string_view id = (*sequence)[frame.next].id();
+      hash = hash_combine(std::hash<std::string_view> {}(id), hash);
+    }
+
+    frame.hash = hash_combine(frame.hash, hash);
+    frame.next++;
+  };
+
+  while (true) {
+    Frame &frame = stack.back();
+
+    if (frame.next < frame.container->children_count()) {
+      const Variant &child = frame.container->is<Sequence>()
+                               ? frame.container->get<Sequence>()[frame.next]
+                               : frame.container->get<Array>()[frame.next];
+
+      if (uint64_t hash = child.flat_hash()) {
+        combine(frame, hash);
+      } else {
+        stack.push_back({&child, 0, child.type()});
+      }
+      continue;
+    }
+
+    uint64_t hash = frame.hash + (frame.hash == 0);
+
+    if (std::atomic<uint64_t> *cache = frame.container->hash_cache()) {
+      cache->store(hash, std::memory_order_relaxed);
+    }
+
+    stack.pop_back();
+
+    if (stack.empty()) {
+      return hash;
+    }
+    combine(stack.back(), hash);
+  }
+}
+
+uint64_t Variant::flat_hash() const {
+  std::atomic<uint64_t> *cache = hash_cache();
+
+  if (uint64_t cached = cache ? cache->load(std::memory_order_relaxed) : 0) {
+    return cached;
+  }
+
+  if (const PackedArray *packed = this->packed()) {
+    uint64_t hash = type();
+
+    packed->visit([&hash]<typename T>(std::span<const T> items) {
+      for (const T &item : items) {
+        hash = hash_combine(hash, hash_scalar(item));
+      }
+    });
+
+    hash += hash == 0;
+
+    if (cache) {
+      cache->store(hash, std::memory_order_relaxed);
+    }
+    return hash;
+  }
+
+  return visit([]<typename A>(const A &value) -> uint64_t {
+    if constexpr (any_of<A, Array, Sequence>) {
+      return 0;
+    } else {
+      return hash_scalar(value);
+    }
+  });
+}
+
+size_t Variant::children_count() const {
+  if (const PackedArray *packed = this->packed()) {
+    return packed->size();
+  }
+  return type() == SEQUENCE ? box<Sequence>()->value.size() : box<Array>()->value.size();
+}
+
+bool Variant::is_leaked() const {
+  if (is_packed()) {
+    return box<PackedArray>()->is_leaked;
+  } else if (type() == ARRAY) {
+    return box<Array>()->is_leaked;
+  }
+  return type() == SEQUENCE && box<Sequence>()->is_leaked;
+}
+
+std::atomic<uint64_t> *Variant::hash_cache() const {
+  auto cache = [](auto *box) -> std::atomic<uint64_t> * {
+    return box->is_leaked ? nullptr : &box->hash;
+  };
+
+  if (is_packed()) {
+    return cache(box<PackedArray>());
+  } else if (type() == ARRAY) {
+    return cache(box<Array>());
+  } else if (type() == SEQUENCE) {
+    return cache(box<Sequence>());
+  }
+  return nullptr;
+}
+
+void Variant::unshare() {
+  auto copy = [this]<typename A>(Box<A> *box) {
+    auto *copy = new Box<A>(box->value);
+    release(box);
+    store(copy);
+  };
+
+  if (is_packed()) {
+    copy(box<PackedArray>());
+  } else if (type() == ARRAY) {
+    copy(box<Array>());
+  } else if (type() == SEQUENCE) {
+    copy(box<Sequence>());
+  }
+}
+
+void Variant::unpack() {
+  emplace<Array>(box<PackedArray>()->value.unpack());
+}
+
+void Variant::reset() {
+  switch (type()) {
+    case ARRAY: {
+      if (is_packed()) {
+        release(box<PackedArray>());
+      } else {
+        release(box<Array>());
+      }
+      break;
+    }
+
+    case SEQUENCE: release(box<Sequence>()); break;
+    case STRING: pointer<String>()->~String(); break;
+    default: break;
+  }
+  clear();
+}
+
 bool Variant::operator==(const Variant &other) const {
-  constexpr auto visitor = []<typename T, typename U>(const T &v, const U &w) {
-    if constexpr (!std::same_as<T, U>) {
+  if (std::optional<bool> is_equal = flat_equal(other)) {
+    return *is_equal;
+  }
+
+  // Containers of equal sizes being compared, child by child
+  struct Frame {
+    const Variant *container, *other;
+    size_t next;
+  };
+
+  std::vector<Frame> stack {{this, &other, 0}};
+
+  while (!stack.empty()) {
+    Frame &frame = stack.back();
+
+    if (frame.next == frame.container->children_count()) {
+      stack.pop_back();
+      continue;
+    }
+
+    size_t n = frame.next++;
+    const Variant *child, *other_child;
+
+    if (const Sequence *sequence = frame.container->get_ptr<Sequence>()) {
+      const Node &member = (*sequence)[n], &other_member = frame.other->get<Sequence>()[n];
+
+      if (member.atom() != other_member.atom()) {
+        return false;
+      }
+
+      child = &member;
+      other_child = &other_member;
+    } else {
+      // Generic copies of the packed arrays compared with generic ones
+      child = &frame.container->get<Array>()[n];
+      other_child = &frame.other->get<Array>()[n];
+    }
+
+    std::optional<bool> is_equal = child->flat_equal(*other_child);
+
+    if (!is_equal) {
+      stack.push_back({child, other_child, 0});
+    } else if (!*is_equal) {
       return false;
-    } else if constexpr (Traits<T>::index == Type::NIL) {
+    }
+  }
+
+  return true;
+}
+
+std::optional<bool> Variant::flat_equal(const Variant &other) const {
+  if (type() != other.type()) {
+    return false;
+  }
+
+  if (type() == ARRAY || type() == SEQUENCE) {
+    // Same box, including the packed flag
+    if (std::memcmp(m_storage, other.m_storage, PACKED + 1) == 0) {
       return true;
-    } else {
-      return v == w;
     }
-  };
 
-  return std::visit(visitor, native(), other.native());
+    auto *cache = hash_cache(), *other_cache = other.hash_cache();
+    uint64_t hash = cache ? cache->load(std::memory_order_relaxed) : 0;
+    uint64_t other_hash = other_cache ? other_cache->load(std::memory_order_relaxed) : 0;
+
+    if (hash && other_hash && hash != other_hash) {
+      return false;
+    }
+
+    if (is_packed() && other.is_packed()) {
+      bool is_equal = packed()->type() == other.packed()->type();
+
+      packed()->visit([&]<typename T>(std::span<const T> items) {
+        is_equal = is_equal && std::ranges::equal(items, other.packed()->items<T>().span());
+      });
+      return is_equal;
+    }
+
+    if (children_count() != other.children_count()) {
+      return false;
+    }
+    return std::nullopt;
+  }
+
+  return visit([&other]<typename A>(const A &value) {
+    if constexpr (any_of<A, std::nullptr_t, Array, Sequence>) {
+      return true;
+    } else {
+      return value == *other.pointer<A>();
+    }
+  });
 }
 
 }  // namespace sdata
@@ -1,11 +1,20 @@
 #ifndef SDATA_VARIANT_HPP
 #define SDATA_VARIANT_HPP
 
+#include "atom.hpp"
 #include "misc/any_of.hpp"
 #include "misc/exception.hpp"
 #include "misc/fmt.hpp"
+#include "misc/hash.hpp"
 #include "traits.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -15,8 +24,135 @@ struct Array : std::vector<class Variant> {
   using std::vector<class Variant>::vector;
 };
 
+// Hash table of the first member position of each identifier, open addressed
+struct SequenceIndex {
+  constexpr static uint32_t EMPTY = UINT32_MAX, ABSENT = UINT32_MAX - 1;
+
+  struct Slot {
+    Atom id {};
+
+    /// First member position of the identifier, ABSENT when no member has it
+    uint32_t position = EMPTY;
+
+    /// Atom::renames() of the identifier when the position was the first one
+    uint32_t renames = 0;
+  };
+
+  std::vector<Slot> slots;
+
+  /// Indexed members count
+  size_t count = 0;
+
+  /// Occupied slots count, the absent identifiers included
+  size_t used = 0;
+};
+
+// Members of a node sequence. Past INDEX_THRESHOLD members, the appended identifiers are indexed
+// for the lookups. The index stays valid as long as the members are appended: the other
+// modifications of the sequence drop it. The member references handed out can rename their
+// member at any time, the index can't see them: each slot records the renames count of its
+// identifier instead. A lookup trusts a slot while no node took its identifier since, otherwise
+// it searches linearly and a non-const lookup refreshes the slot. Renames elsewhere only affect
+// the lookups of the same identifiers
 struct Sequence : std::vector<class Node> {
-  using std::vector<class Node>::vector;
+  using Base = std::vector<class Node>;
+
+  constexpr static size_t INDEX_THRESHOLD = 32;
+
+  Sequence() = default;
+  Sequence(std::initializer_list<class Node> members);
+  Sequence(const Sequence &other);
+  Sequence(Sequence &&other) noexcept = default;
+  Sequence &operator=(const Sequence &other);
+  Sequence &operator=(Sequence &&other) noexcept = default;
+  ~Sequence() = default;
+
+  /// First member with the identifier, indexed past INDEX_THRESHOLD members
+  class Node *find(Atom id);
+
+  /// First const member with the identifier, the index is used only if up to date
+  const class Node *find(Atom id) const;
+
+  /// First member with the identifier, nullptr if it was never interned
+  class Node *find(std::string_view id);
+
+  /// First const member with the identifier, nullptr if it was never interned
+  const class Node *find(std::string_view id) const;
+
+  void push_back(const class Node &member);
+  void push_back(class Node &&member);
+
+  template<typename... Args>
+  class Node &emplace_back(Args &&...args) {
+    Base::emplace_back(std::forward<Args>(args)...);
+    index_back();
+    return back();
+  }
+
+  template<typename... Args>
+  auto insert(Args &&...args) {
+    m_index.reset();
+    return Base::insert(std::forward<Args>(args)...);
+  }
+
+  auto insert(const_iterator position, std::initializer_list<class Node> members) {
+    m_index.reset();
+    return Base::insert(position, members);
+  }
+
+  template<typename... Args>
+  auto erase(Args &&...args) {
+    m_index.reset();
+    return Base::erase(std::forward<Args>(args)...);
+  }
+
+  template<typename... Args>
+  void assign(Args &&...args) {
+    m_index.reset();
+    Base::assign(std::forward<Args>(args)...);
+  }
+
+  template<typename... Args>
+  void resize(Args &&...args) {
+    m_index.reset();
+    Base::resize(std::forward<Args>(args)...);
+  }
+
+  void pop_back() {
+    m_index.reset();
+    Base::pop_back();
+  }
+
+  void clear() {
+    m_index.reset();
+    Base::clear();
+  }
+
+  void swap(Sequence &other) {
+    Base::swap(other);
+    m_index.swap(other.m_index);
+  }
+
+  /// Whether the lookups use the index
+  bool is_indexed() const;
+
+private:
+  /// Member found through the index, is_exact is cleared when its slot had to be bypassed
+  const class Node *index_search(Atom id, bool &is_exact) const;
+
+  /// First member with the identifier from the position on
+  const class Node *linear_search(Atom id, size_t position) const;
+
+  /// Slot of the identifier, the empty slot ending its probe sequence if not indexed
+  SequenceIndex::Slot &slot(Atom id) const;
+
+  /// Update the slot of the identifier after a linear search
+  void refresh(Atom id, const class Node *found);
+
+  void index_back();
+  void reindex();
+
+  std::unique_ptr<SequenceIndex> m_index;
 };
 
 class VariantException : public Exception {
@@ -32,39 +168,180 @@ private:
   const Variant &m_variant;
 };
 
-// std::variant<...> wrapper
-class Variant {
-  template<typename T, typename V>
-  static auto *get_variant(V &variant) {
-    return std::get_if<Traits<T>::index>(&variant);
+// Contiguous items of a packed array, unlike std::vector<bool>
+template<typename T>
+class Packed {
+public:
+  Packed() = default;
+
+  Packed(const Packed &other) : m_size(other.m_size), m_capacity(other.m_size) {
+    m_items = std::make_unique_for_overwrite<T[]>(m_size);
+    std::copy_n(other.m_items.get(), m_size, m_items.get());
+  }
+
+  Packed(Packed &&other) noexcept :
+    m_items(std::move(other.m_items)),
+    m_size(std::exchange(other.m_size, 0)),
+    m_capacity(std::exchange(other.m_capacity, 0)) {}
+
+  Packed &operator=(Packed other) noexcept {
+    std::swap(m_items, other.m_items);
+    std::swap(m_size, other.m_size);
+    std::swap(m_capacity, other.m_capacity);
+    return *this;
+  }
+
+  void reserve(size_t capacity) {
+    if (capacity > m_capacity) {
+      auto items = std::make_unique_for_overwrite<T[]>(capacity);
+      std::move(m_items.get(), m_items.get() + m_size, items.get());
+      m_items = std::move(items);
+      m_capacity = capacity;
+    }
+  }
+
+  void push_back(T item) {
+    if (m_size == m_capacity) {
+      reserve(std::max<size_t>(8, m_capacity * 2));
+    }
+    m_items[m_size++] = std::move(item);
+  }
+
+  inline size_t size() const {
+    return m_size;
+  }
+
+  inline std::span<T> span() {
+    return {m_items.get(), m_size};
+  }
+
+  inline std::span<const T> span() const {
+    return {m_items.get(), m_size};
+  }
+
+private:
+  std::unique_ptr<T[]> m_items;
+  size_t m_size = 0, m_capacity = 0;
+};
+
+// Homogeneous array of ints, floats, bools or strings stored contiguously, see Variant::span().
+// Only the items of the array type are allocated. The generic accessors of the variant read a copy
+// of the items allocated on the first generic access, the mutable ones unpack the array
+class PackedArray {
+public:
+  /// Minimum items count of the arrays packed by the parser, smaller ones are cheaper generic
+  constexpr static size_t PACK_THRESHOLD = 16;
+
+  /// Pack the items of the array, they are all of the type
+  PackedArray(Type type, const Array &array);
+  PackedArray(const PackedArray &other);
+  ~PackedArray();
+
+  inline Type type() const {
+    constexpr Type TYPES[] = {INT, FLOAT, BOOL, STRING};
+    return TYPES[m_items.index()];
   }
 
-  template<typename T, typename V>
-  static auto &emplace_variant(V &variant, T data) {
-    return variant.template emplace<Traits<T>::index>(data);
+  inline size_t size() const {
+    return std::visit([](const auto &items) { return items.size(); }, m_items);
+  }
+
+  template<typename T>
+  Packed<T> &items() {
+    return std::get<Packed<T>>(m_items);
+  }
+
+  template<typename T>
+  const Packed<T> &items() const {
+    return std::get<Packed<T>>(m_items);
   }
 
+  /// Call the visitor with the items span
+  template<typename F>
+  void visit(F &&visitor) const {
+    std::visit([&visitor](const auto &items) { visitor(items.span()); }, m_items);
+  }
+
+  /// Generic copy of the items, built on the first call after a mutable access
+  const Array &generic() const;
+
+  /// Drop the generic copy before a mutable access
+  void invalidate();
+
+  Array unpack() const;
+
+private:
+  std::variant<Packed<int>, Packed<float>, Packed<bool>, Packed<String>> m_items;
+
+  /// Published once built, the concurrent builders keep the first copy
+  mutable std::atomic<Array *> m_generic = nullptr;
+};
+
+// Tagged value of 16 bytes. Scalars and strings are stored inline, strings without allocation up
+// to String::INLINE_CAPACITY characters, arrays and sequences are boxed on the heap, homogeneous
+// arrays can be packed (see PackedArray). A moved variant is left nil.
+// Boxes are shared by the copies and copied on the first mutable access of a sharing variant, so
+// that mutating a copy only copies the path to the modified value. A box whose mutable reference
+// was taken is copied instead of shared until share() is called
+class Variant {
 public:
-  /// Wrapped std::variant templated type
-  using Native = std::variant<std::nullptr_t, Array, Sequence, float, int, bool, std::string>;
+  /// Alternatives in the Type order, see native()
+  using Native = std::variant<std::nullptr_t, Array, Sequence, float, int, bool, String>;
+
+  /// Stored alternative of the type <T>
+  template<typename T>
+  using Alternative = std::variant_alternative_t<Traits<T>::index, Native>;
 
   /// Variant data constructor
-  Variant(auto data) {
-    emplace_variant(m_variant, data);
+  template<typename T>
+  requires(!std::derived_from<T, Variant>) Variant(T data) : Variant() {
+    emplace<T>(std::move(data));
   }
 
   /// Variant sequence constructor
-  Variant(std::initializer_list<class Node> sequence) {
-    emplace_variant(m_variant, sequence);
+  Variant(std::initializer_list<class Node> sequence) : Variant() {
+    emplace<Sequence>(sequence);
   }
 
-  Variant() : m_variant(nullptr) {}
+  Variant() : m_type(NIL) {
+    new (m_storage) std::nullptr_t(nullptr);
+  }
+
+  Variant(Variant &&other) noexcept : m_type(other.m_type) {
+    std::memcpy(m_storage, other.m_storage, sizeof(m_storage));
+    other.clear();
+  }
 
-  Variant(const Variant &) = default;
+  Variant(const Variant &other);
+
+  Variant &operator=(Variant &&other) noexcept {
+    if (this != &other) {
+      // The other variant may be a child of this one, it's moved before the reset
+      Variant moved {std::move(other)};
+      reset();
+      std::memcpy(m_storage, moved.m_storage, sizeof(m_storage));
+      m_type = moved.m_type;
+      moved.clear();
+    }
+    return *this;
+  }
+
+  Variant &operator=(const Variant &other) {
+    if (this != &other) {
+      *this = Variant {other};
+    }
+    return *this;
+  }
+
+  ~Variant() {
+    if (m_type == ARRAY || m_type == SEQUENCE || m_type == STRING) {
+      reset();
+    }
+  }
 
   /// Variant alternative index
   inline Type type() const {
-    return static_cast<Type>(m_variant.index());
+    return static_cast<Type>(m_type);
   }
 
   /// Does the variant contain value of type <T> ?
@@ -74,39 +351,100 @@ public:
   }
 
   /// Assigns the variant value
-  inline auto &operator=(auto data) {
-    return set(data);
+  template<typename T>
+  requires(!std::derived_from<T, Variant>) inline auto &operator=(T data) {
+    return set(std::move(data));
   }
 
-  /// Get the wrapped std::variant
-  const Native &native() const {
-    return m_variant;
+  /// Copy of the value as a std::variant
+  Native native() const {
+    return visit([]<typename A>(const A &value) {
+      return Native {std::in_place_type<A>, value};
+    });
   }
 
-  /// Get the wrapped std::variant
-  Native &native() {
-    return m_variant;
+  /// Call the visitor with the alternative reference
+  template<typename F>
+  std::invoke_result_t<F, const std::nullptr_t &> visit(F &&visitor) const {
+    switch (type()) {
+      case ARRAY: return visitor(*pointer<Array>());
+      case SEQUENCE: return visitor(*pointer<Sequence>());
+      case FLOAT: return visitor(*pointer<float>());
+      case INT: return visitor(*pointer<int>());
+      case BOOL: return visitor(*pointer<bool>());
+      case STRING: return visitor(*pointer<String>());
+      default: return visitor(*pointer<std::nullptr_t>());
+    }
   }
 
   /// Assigns the variant value
   template<typename T>
   inline auto &set(T data) {
-    return emplace_variant(m_variant, data);
+    emplace<T>(std::move(data));
+    return *pointer<Alternative<T>>();
   }
 
   /// Get the variant alternative <T> or a default-constructed value if not available
   template<typename T>
   inline auto &as() {
-    return is<T>() ? *get_variant<T>(m_variant) : emplace_variant<T>(m_variant, T {});
+    if (!is<T>()) {
+      emplace<T>(T {});
+    }
+    return *pointer<Alternative<T>>();
+  }
+
+  /// Is the array packed, see pack()
+  inline bool is_packed() const {
+    return m_type == ARRAY && m_storage[PACKED];
+  }
+
+  /// Packed items of the array, nullptr if not packed
+  inline const PackedArray *packed() const {
+    return is_packed() ? &box<PackedArray>()->value : nullptr;
   }
 
+  /// Store the items of an array of ints, floats, bools or strings contiguously, the references to
+  /// the items are invalidated. False if the array is empty or not homogeneous
+  bool pack();
+
+  /// Items of an array packed as <T>
+  template<typename T>
+  std::span<const Alternative<T>> span() const {
+    if (!is_packed() || packed()->type() != Traits<T>::index) {
+      throw_array_unpacked<T>();
+    }
+    return packed()->items<Alternative<T>>().span();
+  }
+
+  /// Mutable items of an array packed as <T>, the array is packed first. The const generic
+  /// accessors read a copy of the items taken on their first call after this one
+  template<typename T>
+  std::span<Alternative<T>> span() {
+    if (!pack() || packed()->type() != Traits<T>::index) {
+      throw_array_unpacked<T>();
+    }
+    return pointer<PackedArray>()->items<Alternative<T>>().span();
+  }
+
+  /// Append an item to the array, a packed array is unpacked if the item isn't of its type
+  void push_back(Variant item);
+
+  /// Let the copies share the containers again, the mutable references to the containers taken
+  /// before are invalidated. Only the containers accessed mutably since the last call are visited
+  void share();
+
+  /// Structural hash of the value, equal variants have equal hashes. It's cached in the containers
+  /// which aren't leaked (see share()), a mutable access to a container clears its cache, and so
+  /// the caches of the containers on the path to a modified value
+  uint64_t hash() const;
+
   /// Get a variant alternative <T> reference
   template<typename T>
   auto &get() {
     if (type() != Traits<T>::index) {
       throw_variant_unavailable<T>();
     }
-    return *get_variant<T>(m_variant);
+    return *pointer<Alternative<T>>();
   }
 
   /// Get a variant alternative <T> const-reference
@@ -115,19 +453,19 @@ public:
     if (type() != Traits<T>::index) {
       throw_variant_unavailable<T>();
     }
-    return *get_variant<T>(m_variant);
+    return *pointer<Alternative<T>>();
   }
 
   /// Get a variant alternative <T> pointer or nullptr if not available
   template<typename T>
   inline const auto *get_ptr() const {
-    return get_variant<T>(m_variant);
+    return is<T>() ? pointer<Alternative<T>>() : nullptr;
   }
 
   /// Get a variant alternative <T> const-pointer or nullptr if not available
   template<typename T>
   inline auto *get_ptr() {
-    return get_variant<T>(m_variant);
+    return is<T>() ? pointer<Alternative<T>>() : nullptr;
   }
 
   /// Get the n-th item of the array
@@ -150,7 +488,8 @@ public:
     return at(n);
   }
 
-  /// Recursive variant value comparator
+  /// Variant value comparator, the containers with different cached hashes differ. The nested
+  /// containers are compared without recursion
   bool operator==(const Variant &other) const;
 
 protected:
@@ -162,7 +501,154 @@ protected:
     };
   }
 
-  Native m_variant;
+  template<typename T>
+  void throw_array_unpacked() const {
+    throw VariantException {
+      fmt("Variant array not packed as <{}>", static_cast<Type>(Traits<T>::index)),
+      this,
+    };
+  }
+
+private:
+  /// Index of the packed array flag, after the box pointer
+  constexpr static size_t PACKED = sizeof(void *);
+
+  template<typename A>
+  constexpr static bool is_boxed = any_of<A, Array, Sequence, PackedArray>;
+
+  template<typename A>
+  struct Box {
+    template<typename... Args>
+    explicit Box(Args &&...args) : value(std::forward<Args>(args)...) {
+      decode_strings(value);
+    }
+
+    /// Variants sharing the box
+    std::atomic<uint32_t> references = 1;
+
+    /// A mutable reference to the value was taken, the copies can't share the box
+    bool is_leaked = false;
+
+    /// Structural hash of the value, zero until computed while the box isn't leaked
+    std::atomic<uint64_t> hash = 0;
+
+    A value;
+  };
+
+  template<typename A>
+  Box<A> *box() const {
+    return *std::launder(reinterpret_cast<Box<A> *const *>(m_storage));
+  }
+
+  template<typename A>
+  void store(Box<A> *box) {
+    new (m_storage) Box<A> *(box);
+    m_storage[PACKED] = std::same_as<A, PackedArray>;
+  }
+
+  /// Mutable access, a shared box is copied first and leaked. A packed array is unpacked for the
+  /// generic access
+  template<typename A>
+  A *pointer() {
+    if constexpr (std::same_as<A, Array>) {
+      if (is_packed()) {
+        unpack();
+      }
+    }
+
+    if constexpr (is_boxed<A>) {
+      if (box<A>()->references.load(std::memory_order_acquire) > 1) {
+        unshare();
+      }
+
+      box<A>()->is_leaked = true;
+      box<A>()->hash.store(0, std::memory_order_relaxed);
+
+      if constexpr (std::same_as<A, PackedArray>) {
+        box<A>()->value.invalidate();
+      }
+      return &box<A>()->value;
+    } else {
+      return std::launder(reinterpret_cast<A *>(m_storage));
+    }
+  }
+
+  template<typename A>
+  const A *pointer() const {
+    if constexpr (std::same_as<A, Array>) {
+      if (is_packed()) {
+        return &box<PackedArray>()->value.generic();
+      }
+    }
+
+    if constexpr (is_boxed<A>) {
+      return &box<A>()->value;
+    } else {
+      return std::launder(reinterpret_cast<const A *>(m_storage));
+    }
+  }
+
+  /// Replace the value, constructed from the data before the previous one is destroyed
+  template<typename T, typename D>
+  void emplace(D &&data) {
+    using A = Alternative<T>;
+
+    if constexpr (is_boxed<A>) {
+      auto *box = new Box<A>(std::forward<D>(data));
+      reset();
+      store(box);
+    } else {
+      A value(std::forward<D>(data));
+      reset();
+      new (m_storage) A(std::move(value));
+    }
+
+    m_type = Traits<T>::index;
+  }
+
+  /// Decode the escaped strings of a box before the variants share it, their lazy decoding
+  /// would race between the threads reading the copies
+  static void decode_strings(Array &array);
+  static void decode_strings(Sequence &sequence);
+  static void decode_strings(PackedArray &packed);
+
+  /// Share the box of the other variant, or copy it if leaked
+  template<typename A>
+  void share_box(const Variant &other);
+
+  /// Hash cache of the container, nullptr if the box is leaked
+  std::atomic<uint64_t> *hash_cache() const;
+
+  /// Hash of a scalar, a packed array or a cached container, zero if the children are needed
+  uint64_t flat_hash() const;
+
+  /// Comparison of the scalars and the packed, shared or differently sized containers,
+  /// std::nullopt if the children are needed
+  std::optional<bool> flat_equal(const Variant &other) const;
+
+  /// Items of an array or members of a sequence
+  size_t children_count() const;
+
+  /// Whether the box of the container is leaked
+  bool is_leaked() const;
+
+  /// Replace the shared box by a copy owned by the variant
+  void unshare();
+
+  /// Replace the packed array by its generic form
+  void unpack();
+
+  /// Destroy the value, the variant is left nil
+  void reset();
+
+  /// Leave the variant nil without destroying the value, it was moved
+  void clear() {
+    m_type = NIL;
+    new (m_storage) std::nullptr_t(nullptr);
+  }
+
+  alignas(8) char m_storage[String::INLINE_CAPACITY + 1];
+  uint8_t m_type;
 };
 
 }  // namespace sdata
@@ -4,19 +4,54 @@ namespace sdata {
 
 Writer::Writer(const Node &node, Format format) : m_format(format) {
   write_node(node, 0);
+  write_tree();
 }
 
 Writer::Writer(const Variant &variant, Format format) : m_format(format) {
   write_variant(variant, 0);
+  write_tree();
+}
+
+void Writer::write_tree() {
+  while (!m_stack.empty()) {
+    Frame &frame = m_stack.back();
+    const Sequence *sequence = frame.container->get_ptr<Sequence>();
+    size_t size = sequence ? sequence->size() : frame.container->get<Array>().size();
+
+    // The previous child is completed
+    if (frame.next > 0) {
+      write_separator(frame.next - 1, size);
+    }
+
+    if (frame.next == size) {
+      write_indent(frame.depth);
+      write("{}", frame.bounds.close);
+      m_stack.pop_back();
+      continue;
+    }
+
+    // The frame reference is invalidated by the opened containers
+    size_t n = frame.next++;
+    int depth = frame.depth + 1;
+    write_indent(depth);
+
+    if (sequence) {
+      write_node((*sequence)[n], depth);
+    } else {
+      write_variant(frame.container->get<Array>()[n], depth);
+    }
+  }
 }
 
 void Writer::write_node(const Node &node, int depth) {
   if (node.is_anonymous()) {
-    return write_container(
-      node.get<Sequence>(),
-      &Writer::write_node,
-      m_format.anonymous_bounds,
-      depth + m_format.anonymous_shift);
+    if (!node.is<Sequence>()) {
+      return write_variant(node, depth);
+    }
+
+    write("{}", m_format.anonymous_bounds.open);
+    m_stack.push_back({&node, m_format.anonymous_bounds, depth + m_format.anonymous_shift});
+    return;
   }
 
   write("{}", node.id());
@@ -31,34 +66,34 @@ void Writer::write_node(const Node &node, int depth) {
 void Writer::write_variant(const Variant &node, int depth) {
   switch (node.type()) {
     case ARRAY: {
-      const auto &array = node.get<Array>();
-      return write_container(array, &Writer::write_variant, m_format.array_bounds, depth);
+      // The packed items are scalars, written in place
+      if (const PackedArray *packed = node.packed()) {
+        return packed->visit([&]<typename T>(std::span<const T> items) {
+          write_container(items.size(), m_format.array_bounds, depth, [&](size_t i) {
+            write_value(items[i]);
+          });
+        });
+      }
+
+      write("{}", m_format.array_bounds.open);
+      m_stack.push_back({&node, m_format.array_bounds, depth});
+      return;
     }
 
     case SEQUENCE: {
-      const auto &sequence = node.get<Sequence>();
-      return write_container(sequence, &Writer::write_node, m_format.sequence_bounds, depth);
+      write("{}", m_format.sequence_bounds.open);
+      m_stack.push_back({&node, m_format.sequence_bounds, depth});
+      return;
     }
 
     case NIL: {
       return write("nil");
     }
 
-    case FLOAT: {
-      return write("{:f}", node.get<float>());
-    }
-
-    case INT: {
-      return write("{:d}", node.get<int>());
-    }
-
-    case BOOL: {
-      return write("{}", node.get<bool>());
-    }
-
-    case STRING: {
-      return write("{}{:s}{}", m_format.quote, node.get<std::string>(), m_format.quote);
-    }
+    case FLOAT: return write_value(node.get<float>());
+    case INT: return write_value(node.get<int>());
+    case BOOL: return write_value(node.get<bool>());
+    case STRING: return write_value(node.get<String>());
 
     default: return;
   }
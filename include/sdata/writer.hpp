@@ -3,6 +3,8 @@
 
 #include "format.hpp"
 #include "misc/basic_writer.hpp"
+#include "misc/escaped.hpp"
+#include <vector>
 
 namespace sdata {
 
@@ -12,29 +14,60 @@ public:
   explicit Writer(const Variant &variant, Format format = Format::inlined());
 
 private:
+  // Container being written, its children are written in turn
+  struct Frame {
+    const Variant *container;
+    Format::Bounds bounds;
+    int depth;
+    size_t next = 0;
+  };
+
+  /// Write the tree without recursion, the open containers are kept on the stack
+  void write_tree();
+
+  /// Write a node or a variant, a container is opened on the stack and written by write_tree()
   void write_node(const Node &node, int depth);
   void write_variant(const Variant &variant, int depth);
+
+  /// Write a scalar, also the items of the packed arrays
+  template<typename T>
+  void write_value(const T &value) {
+    if constexpr (std::same_as<T, float>) {
+      write("{:f}", value);
+    } else if constexpr (std::same_as<T, int>) {
+      write("{:d}", value);
+    } else if constexpr (std::same_as<T, bool>) {
+      write("{}", value);
+    } else {
+      write("{}", m_format.quote);
+      escape(value.view(), m_format.quote.front(), m_buffer);
+      write("{}", m_format.quote);
+    }
+  }
+
   void write_indent(int depth);
 
-  void write_container(const auto &container, auto write_fn, Format::Bounds bounds, int depth) {
+  /// Write the bounds and the separators of the container, the children are written by the
+  /// function
+  void write_container(size_t size, Format::Bounds bounds, int depth, auto write_child) {
     write("{}", bounds.open);
 
-    for (size_t i = 0; i < container.size(); i++) {
+    for (size_t i = 0; i < size; i++) {
       write_indent(depth + 1);
-      (this->*write_fn)(container[i], depth + 1);
-
-      if (i < container.size() - 1) {
-        write("{}", m_format.separator);
-      } else {
-        write("{}", m_format.container_end);
-      }
+      write_child(i);
+      write_separator(i, size);
     }
 
     write_indent(depth);
     write("{}", bounds.close);
   }
 
+  inline void write_separator(size_t i, size_t size) {
+    write("{}", i < size - 1 ? m_format.separator : m_format.container_end);
+  }
+
   Format m_format;
+  std::vector<Frame> m_stack {};
 };
 
 inline std::ostream &operator<<(std::ostream &os, Node &node) {
@@ -0,0 +1,63 @@
+#include "allocations.hpp"
+#include <cstdlib>
+#include <new>
+
+// The complete set of the replaceable allocation functions, so that every allocation is paired
+// with the matching deallocation. The aligned overloads keep their default implementations
+static thread_local size_t *counter = nullptr;
+
+size_t *swap_allocations_counter(size_t *replacement) {
+  size_t *previous = counter;
+  counter = replacement;
+  return previous;
+}
+
+static void *allocate(size_t size) noexcept {
+  if (counter) {
+    ++*counter;
+  }
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new(size_t size) {
+  if (void *pointer = allocate(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc {};
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+  std::free(pointer);
+}
@@ -0,0 +1,27 @@
+#ifndef SDATA_ALLOCATIONS_HPP
+#define SDATA_ALLOCATIONS_HPP
+
+#include <cstddef>
+
+/// Replace the allocations counter of the thread, null when not counting. Returns the previous one
+size_t *swap_allocations_counter(size_t *counter);
+
+/// Heap allocations made by the thread while calling the function, counted by the global
+/// operator new replaced in allocations.cpp
+template<typename F>
+size_t count_allocations(F &&function) {
+  size_t count = 0;
+  size_t *previous = swap_allocations_counter(&count);
+
+  try {
+    function();
+  } catch (...) {
+    swap_allocations_counter(previous);
+    throw;
+  }
+
+  swap_allocations_counter(previous);
+  return count;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef SDATA_ATOM_TEST_HPP
+#define SDATA_ATOM_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+#include <thread>
+
+using namespace sdata;
+
+TEST_CASE("Atom") {
+  SECTION("interning") {
+    std::string id = "interned_atom";
+    CHECK(Atom::find(id).empty());
+
+    Atom atom {id};
+    id[0] = 'I';
+    CHECK(atom.view() == "interned_atom");
+    CHECK(atom == Atom {"interned_atom"});
+    CHECK(atom == Atom::find("interned_atom"));
+    CHECK(atom != Atom {id});
+    CHECK(Atom {""}.empty());
+  }
+
+  SECTION("nodes share their identifiers") {
+    Node records = parse_str("records { r: [1], r: [2], { r: [3] } }");
+    const Sequence &members = records.get<Sequence>();
+    CHECK(members[0].id().data() == members[1].id().data());
+    CHECK(members[0].atom() == members[2].get<Sequence>()[0].atom());
+    CHECK(records.search("never_interned_id") == nullptr);
+    CHECK(&records.at("r") == &members[0]);
+  }
+
+  SECTION("limit") {
+    size_t limit = Atom::limit();
+    Node records = parse_str("records { r: [1] }");
+    Atom::set_limit(Atom::count());
+
+    CHECK_THROWS_AS(Atom {"limited_atom"}, AtomException);
+    CHECK_THROWS_AS(parse_str("records { limited_member: 1 }"), AtomException);
+    CHECK(parse_str("records { r: [1] }") == records);
+    CHECK(Atom::find("limited_atom").empty());
+    CHECK(Atom::count() == Atom::limit());
+
+    Atom::set_limit(limit);
+    CHECK_FALSE(Atom {"limited_atom"}.empty());
+  }
+
+  SECTION("threads") {
+    std::vector<std::thread> threads {};
+    std::vector<Atom> atoms(8);
+
+    for (size_t n = 0; n < atoms.size(); n++) {
+      threads.emplace_back([&atoms, n] {
+        for (size_t m = 0; m < 1000; m++) {
+          atoms[n] = Atom {sdata::fmt("thread_atom_{}", m)};
+        }
+      });
+    }
+
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    CHECK(std::all_of(atoms.begin(), atoms.end(), [&atoms](Atom atom) {
+      return atom == atoms[0] && atom.view() == "thread_atom_999";
+    }));
+  }
+}
+
+#endif
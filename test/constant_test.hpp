@@ -0,0 +1,67 @@
+#ifndef SDATA_CONSTANT_TEST_HPP
+#define SDATA_CONSTANT_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+using namespace sdata::literals;
+
+constexpr ConstantNode constant_game = R"(
+  # defaults #
+  tetris {
+    window { width: 1920, height: 1080, scale: -1.25, title: 'Tetris\tgame' },
+    colors: [[0, 128, 255], [true, nil]],
+    { anonymous: "x" }
+  }
+)"_sdata;
+
+static_assert(constant_game.id() == "tetris");
+static_assert(constant_game.size() == 3);
+static_assert(constant_game.at("window").at("width").get<int>() == 1920);
+static_assert(constant_game.at("window").at("scale").get<float>() == -1.25f);
+static_assert("a: 1.5f"_sdata.get<float>() == 1.5f);
+static_assert(constant_game.at("window").at("title").get<std::string_view>() == "Tetris\tgame");
+static_assert(constant_game.at("colors")[0][2].get<int>() == 255);
+static_assert(constant_game.at("colors")[1][1].type() == NIL);
+static_assert(constant_game[2].is_anonymous());
+
+TEST_CASE("Constant") {
+  SECTION("node") {
+    Node node = constant_game;
+
+    CHECK(node == parse_str(R"(
+      tetris {
+        window { width: 1920, height: 1080, scale: -1.25, title: 'Tetris\tgame' },
+        colors: [[0, 128, 255], [true, nil]],
+        { anonymous: "x" }
+      })"));
+    CHECK(Node {""_sdata} == parse_str(""));
+    CHECK(Node {"a: [-2147483648, 0.5]"_sdata} == parse_str("a: [-2147483648, 0.5]"));
+    CHECK(Node {"a { b: 1.5f, c: [-0.1f, 3.14159] }"_sdata} ==
+          parse_str("a { b: 1.5f, c: [-0.1f, 3.14159] }"));
+  }
+
+  SECTION("errors") {
+    auto parse = [](std::string_view source) {
+      ConstantParser parser {source};
+      parser.parse();
+    };
+
+    CHECK_NOTHROW(parse("a { b: 1 }"));
+    CHECK_THROWS_AS(parse("a { b: }"), Exception);
+    CHECK_THROWS_AS(parse("a { b: 1, }"), Exception);
+    CHECK_THROWS_AS(parse("a { b: 1 } c"), Exception);
+    CHECK_THROWS_AS(parse("a: 'b"), Exception);
+    CHECK_THROWS_AS(parse("a: +1"), Exception);
+    CHECK_THROWS_AS(parse("a: 2147483648"), Exception);
+    CHECK_THROWS_AS(parse("a: 1. # b"), Exception);
+    CHECK_THROWS_AS(parse("a: 1f"), Exception);
+    CHECK_THROWS_AS(parse("a: 1.5ff"), Exception);
+    CHECK_THROWS_AS(parse(std::string(257, '{')), Exception);
+    CHECK_THROWS_AS(constant_game.at("audio"), Exception);
+    CHECK_THROWS_AS(constant_game.get<int>(), Exception);
+  }
+}
+
+#endif
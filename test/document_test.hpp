@@ -0,0 +1,94 @@
+#ifndef SDATA_DOCUMENT_TEST_HPP
+#define SDATA_DOCUMENT_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+static SourceSpan document_span(std::string_view source) {
+  Parser parser {source, {.spans = true}};
+  parser.parse();
+  return parser.span();
+}
+
+TEST_CASE("Document") {
+  std::string source =
+    "tetris {\n"
+    "  window { width: 1920, height: 1080 },\n"
+    "  colors: [[0, 0, 0], [255, 255, 255]],\n"
+    "  title: 'tetris'\n"
+    "}";
+
+  Document document {source};
+  REQUIRE(document.root() == parse_str(source));
+
+  auto edit = [&](std::string_view from, std::string_view to) {
+    size_t begin = document.source().find(from);
+    return document.edit(begin, begin + from.size(), to);
+  };
+
+  auto check = [&] {
+    CHECK(document.root() == parse_str(document.source()));
+    CHECK(document.span() == document_span(document.source()));
+  };
+
+  SECTION("value") {
+    CHECK(edit("1920", "1280") == std::vector<std::string> {"window.width"});
+    check();
+    CHECK(document.root().at("window").at("width").get<int>() == 1280);
+  }
+
+  SECTION("array item") {
+    CHECK(edit("255, 255", "128, 255") == std::vector<std::string> {"colors[1][0]"});
+    check();
+  }
+
+  SECTION("identifier") {
+    CHECK(edit("title", "name") == std::vector<std::string> {"title", "name"});
+    check();
+  }
+
+  SECTION("structure") {
+    CHECK(edit("height: 1080", "height: 1080, depth: 32") == std::vector<std::string> {"window"});
+    check();
+    CHECK(edit(", depth: 32", "") == std::vector<std::string> {"window"});
+    check();
+    CHECK(document.root() == parse_str(source));
+  }
+
+  SECTION("relative spans") {
+    const DocumentSpan &root = document.relative_span();
+    DocumentSpan colors = root.children[1];
+    const DocumentSpan *items = root.children[1].children.data();
+    size_t title = root.children[2].offset;
+
+    CHECK(edit("1920", "1920000") == std::vector<std::string> {"window.width"});
+    check();
+
+    // Only the following siblings along the edited path moved
+    CHECK(root.children[1].offset == colors.offset + 3);
+    CHECK(root.children[1].children == colors.children);
+    CHECK(root.children[1].children.data() == items);
+    CHECK(root.children[2].offset == title + 3);
+    CHECK(root.children[0].children[1].offset == document.source().find("height") - 11);
+  }
+
+  SECTION("root") {
+    CHECK(edit("tetris {", "game {") == std::vector<std::string> {""});
+    check();
+  }
+
+  SECTION("error") {
+    CHECK_THROWS_AS(edit("1080", "'1080"), ParserException);
+    CHECK(document.source() == source);
+    check();
+  }
+
+  SECTION("range") {
+    CHECK_THROWS_AS(document.edit(4, 2, ""), DocumentException);
+    CHECK_THROWS_AS(document.edit(0, source.size() + 1, ""), DocumentException);
+  }
+}
+
+#endif
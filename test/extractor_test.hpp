@@ -0,0 +1,53 @@
+#ifndef SDATA_EXTRACTOR_TEST_HPP
+#define SDATA_EXTRACTOR_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("Extractor") {
+  std::string_view source =
+    "game {\n"
+    "  # {[ skipped ]} #\n"
+    "  window { width: 1920, height: 1080, title: 'a {b} [c]' },\n"
+    "  { anonymous: 1 },\n"
+    "  levels: [[1, 2], [3, \"]\"]],\n"
+    "  audio { volume: 0.5, muted: false },\n"
+    "  window { width: 0 }\n"
+    "}";
+
+  SECTION("paths") {
+    Node node = extract(source, {"window.width", "audio.volume"});
+
+    CHECK(node.id() == "game");
+    CHECK(node.get<Sequence>().size() == 2);
+    CHECK(node.at("window").get<Sequence>().size() == 1);
+    CHECK(node.at("window").at("width").get<int>() == 1920);
+    CHECK(node.at("audio").at("volume").get<float>() == .5f);
+  }
+
+  SECTION("whole members") {
+    Node node = extract(source, {"levels", "audio", "audio.muted"});
+    Node full = parse_str(source);
+
+    CHECK(node.at("levels") == full.at("levels"));
+    CHECK(node.at("audio") == full.at("audio"));
+  }
+
+  SECTION("missing") {
+    Node node = extract(source, {"window.depth", "levels.first", "menu"});
+
+    CHECK(node.get<Sequence>().size() == 1);
+    CHECK(node.at("window").get<Sequence>().empty());
+  }
+
+  SECTION("fallback") {
+    // Unmatched quote within a skipped member, the skimmer can't find the boundaries
+    CHECK_THROWS_AS(extract("a { b: 'x, c: 1 }", {"c"}), ParserException);
+    CHECK_THROWS_AS(extract("a { b { c: } }", {"b"}), ParserException);
+    CHECK(extract("a: 1", {"b"}) == Node {"a", Sequence {}});
+  }
+}
+
+#endif
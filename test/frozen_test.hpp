@@ -0,0 +1,87 @@
+#ifndef SDATA_FROZEN_TEST_HPP
+#define SDATA_FROZEN_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("Frozen") {
+  Node game = parse_str(R"(
+    tetris {
+      window { width: 1920, height: 1080, scale: -1.25, title: 'Tetris\tgame' },
+      colors: [[0, 128, 255], [true, nil], ['red', "blue"]],
+      { width: 4 }
+    })");
+
+  SECTION("view") {
+    Frozen frozen = freeze(game);
+    FrozenNode root = frozen.root();
+
+    CHECK(root.id() == "tetris");
+    CHECK(root.size() == 3);
+    CHECK(root.at("window").at("width").get<int>() == 1920);
+    CHECK(root.at("window").at("scale").get<float>() == -1.25f);
+    CHECK(root.at("window").at("title").get<std::string_view>() == "Tetris\tgame");
+    CHECK(root.at("window").at("title").get<std::string>() == "Tetris\tgame");
+    CHECK(root.at("colors")[0][2].get<int>() == 255);
+    CHECK(root.at("colors")[1][0].get<bool>());
+    CHECK(root.at("colors")[1][1].is<std::nullptr_t>());
+    CHECK(root.at("colors")[2][1].get<std::string_view>() == "blue");
+    CHECK(root[2].is_anonymous());
+    CHECK(root[2].at("width").get<int>() == 4);
+    CHECK_FALSE(root.search("audio"));
+    CHECK_FALSE(root.at("window").at("width").search("width"));
+  }
+
+  SECTION("iteration") {
+    Frozen frozen = freeze(game);
+    std::vector<std::string_view> ids {};
+    int sum = 0;
+
+    for (FrozenNode member : frozen.root()) {
+      ids.push_back(member.id());
+    }
+
+    for (FrozenNode item : frozen.root().at("colors")[0]) {
+      sum += item.get<int>();
+    }
+
+    CHECK(ids == std::vector<std::string_view> {"window", "colors", ""});
+    CHECK(sum == 383);
+  }
+
+  SECTION("layout") {
+    Frozen frozen = freeze(game);
+    FrozenNode root = frozen.root();
+
+    // One entry per node and array item
+    CHECK(frozen.size() == 19);
+
+    // Breadth-first, the identifiers are pooled once
+    CHECK(root[0].id().data() < root.at("window")[0].id().data());
+    CHECK(root[2].at("width").id().data() == root.at("window").at("width").id().data());
+  }
+
+  SECTION("copies") {
+    Frozen frozen = freeze(game);
+    Frozen copy = frozen;
+    Frozen moved = std::move(frozen);
+
+    CHECK(copy.bytes() == moved.bytes());
+    CHECK(copy.root().at("window").at("height").get<int>() == 1080);
+    CHECK(moved.root().at("colors")[2][0].get<std::string_view>() == "red");
+    CHECK(Node {copy.root()} == game);
+    CHECK(Node {freeze(Node {"empty"}).root()} == Node {"empty"});
+  }
+
+  SECTION("errors") {
+    Frozen frozen = freeze(game);
+
+    CHECK_THROWS_AS(frozen.root().at("audio"), FrozenException);
+    CHECK_THROWS_AS(frozen.root()[3], FrozenException);
+    CHECK_THROWS_AS(frozen.root().at("window").at("width").get<float>(), FrozenException);
+  }
+}
+
+#endif
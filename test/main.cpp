@@ -1,8 +1,20 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
 //
+#include "atom_test.hpp"
+#include "constant_test.hpp"
+#include "document_test.hpp"
+#include "extractor_test.hpp"
+#include "frozen_test.hpp"
+#include "node_builder_test.hpp"
 #include "node_test.hpp"
+#include "parallel_parser_test.hpp"
 #include "parser_test.hpp"
+#include "patcher_test.hpp"
+#include "path_test.hpp"
+#include "push_parser_test.hpp"
+#include "record_reader_test.hpp"
 #include "regex_test.hpp"
 #include "scanner_test.hpp"
+#include "traversal_test.hpp"
 #include "writer_test.hpp"
@@ -0,0 +1,71 @@
+#ifndef SDATA_NODE_BUILDER_TEST_HPP
+#define SDATA_NODE_BUILDER_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("NodeBuilder") {
+  SECTION("members") {
+    NodeBuilder builder {"window"};
+    Node title {"title", "Tetris"};
+
+    builder.reserve(4).append("width", 1920).append(Node {"height", 1080}).append(title);
+    CHECK(builder.size() == 3);
+
+    Node window = builder.build();
+    CHECK(window == Node {"window", {Node {"width", 1920}, Node {"height", 1080}, title}});
+    CHECK(builder.size() == 0);
+    CHECK(builder.build() == Node {"window", Sequence {}});
+    CHECK_THROWS_AS(NodeBuilder {"in valid"}, NodeException);
+  }
+
+  SECTION("duplicated identifiers") {
+    NodeBuilder builder {"members"};
+    Node inserted {"members", Sequence {}};
+
+    for (int n = 0; n < 100; n++) {
+      std::string id = sdata::fmt("m{}", n % 40);
+      builder.append(id, n);
+      inserted.insert(id, n);
+    }
+
+    Node built = builder.build();
+    CHECK(built.get<Sequence>().size() == 40);
+    CHECK(built.at("m0").get<int>() == 80);
+    CHECK(built.at("m39").get<int>() == 79);
+    CHECK(built == inserted);
+  }
+
+  SECTION("anonymous members") {
+    NodeBuilder builder {"members"};
+    Node inserted {"members", Sequence {}};
+
+    for (int n = 0; n < 3; n++) {
+      builder.append("", n).append("named", n);
+      inserted.insert("", n);
+      inserted.insert("named", n);
+    }
+
+    // Node::insert() replaces the first anonymous member, the builder keeps them all
+    Node built {"members", {Node {"", 0}, Node {"named", 2}, Node {"", 1}, Node {"", 2}}};
+    CHECK(inserted == Node {"members", {Node {"", 2}, Node {"named", 2}}});
+    CHECK(builder.build() == built);
+  }
+
+  SECTION("unchecked") {
+    NodeBuilder builder {"records"};
+    builder.reserve(1000);
+
+    for (int n = 0; n < 1000; n++) {
+      builder.append(Node {sdata::fmt("r{}", n), n});
+    }
+
+    Node records = builder.build_unchecked();
+    CHECK(records.get<Sequence>().size() == 1000);
+    CHECK(records.at("r999").get<int>() == 999);
+  }
+}
+
+#endif
@@ -55,4 +55,370 @@ TEST_CASE("Node: nested") {
   CHECK(s.nested.nested.name == "hello");
 }
 
+TEST_CASE("Node: identifiers") {
+  for (std::string_view id : {"a", "_", "Z9", "snake_case_1", "_0"}) {
+    CHECK(is_identifier(id));
+    CHECK(Node {id}.id() == id);
+  }
+
+  for (std::string_view id : {"9a", "a-b", "a b", "a.b", "\xe9t\xe9"}) {
+    CHECK_FALSE(is_identifier(id));
+    CHECK_THROWS_AS(Node {id}, NodeException);
+  }
+
+  Node node {"node", Sequence {}};
+  CHECK_THROWS_AS(node.insert("0", 1), NodeException);
+  CHECK(Node::trusted("scanned", 1) == Node {"scanned", 1});
+  static_assert(is_identifier("checked_at_compile_time"));
+}
+
+TEST_CASE("Node: compact representation") {
+  CHECK(sizeof(Variant) == 16);
+  CHECK(sizeof(Node) == 24);
+
+  SECTION("strings") {
+    std::string source = "a string longer than the inline capacity";
+    Variant shorter = "short", longer = source, borrowed = String::borrow(source);
+    CHECK(shorter.get<std::string>() == "short");
+    CHECK(longer.get<std::string>() == source);
+    CHECK(longer.get<std::string>().data() != source.data());
+    CHECK(borrowed.get<std::string>().data() == source.data());
+
+    std::string converted = borrowed.get<std::string>();
+    std::string_view viewed = borrowed.get<std::string>();
+    CHECK(converted == source);
+    CHECK(viewed.data() == source.data());
+
+    Variant copy = longer;
+    longer.get<String>().assign("reused buffer");
+    CHECK(copy.get<std::string>() == source);
+    CHECK(longer.get<std::string>() == "reused buffer");
+
+    Variant escaped = String::borrow_escaped("tab\\tand\\nnewline, escaped in the source");
+    CHECK(escaped.get<std::string>() == "tab\tand\nnewline, escaped in the source");
+    CHECK_FALSE(escaped.get<String>().is_borrowed());
+  }
+
+  SECTION("containers") {
+    Variant array = Array {1, 2.5f, "three", Array {true, nullptr}};
+    Variant moved = std::move(array);
+    CHECK(array.is<std::nullptr_t>());
+    CHECK(moved[3][0].get<bool>());
+
+    // Assignment from a child of the variant
+    moved = moved[3];
+    CHECK(moved == Array {true, nullptr});
+    CHECK(moved.native().index() == ARRAY);
+  }
+}
+
+TEST_CASE("Node: deep trees") {
+  // Deeper than the parser max depth, the walks and the destruction don't recurse
+  constexpr size_t DEPTH = 100000;
+
+  auto build = [](int leaf) {
+    Node root {"root", Sequence {}};
+    Node *node = &root;
+
+    for (size_t n = 0; n < DEPTH; n++) {
+      node = &node->insert(Node {"child", n % 2 ? Variant {Sequence {}} : Variant {Array {}}});
+
+      if (node->is<Array>()) {
+        node->get<Array>().push_back(Sequence {});
+        node = &node->get<Array>()[0].get<Sequence>().emplace_back("item", Sequence {});
+      }
+    }
+
+    node->insert("leaf", leaf);
+    return root;
+  };
+
+  Node tree = build(1), same = build(1), other = build(2);
+  tree.share();
+
+  CHECK(tree == same);
+  CHECK(tree != other);
+  CHECK(tree.hash() == same.hash());
+  CHECK(tree.hash() != other.hash());
+
+  Writer writer {tree, Format::inlined()};
+  std::string_view written = writer.buffer();
+  CHECK(written.starts_with("root { child:  [  { item { child { child:  [  { item {"));
+  CHECK(written.find("{ leaf: 1 } } } ] } } }") != std::string_view::npos);
+
+  const Node copy = tree;
+  CHECK(&copy.get<Sequence>() == &std::as_const(tree).get<Sequence>());
+}
+
+TEST_CASE("Node: shared copies") {
+  Node state = parse_str("state { player { x: 1, items: [1, 2] }, world { seed: 7 } }");
+  const Node &view = state;
+
+  SECTION("mutable references are not shared") {
+    Array &items = state.at("player").at("items").get<Array>();
+    Node copy = state;
+    items.push_back(3);
+    CHECK(copy.at("player").at("items").get<Array>() == Array {1, 2});
+    CHECK(view.at("player").at("items").get<Array>() == Array {1, 2, 3});
+  }
+
+  SECTION("parsed trees") {
+    // The parsed boxes aren't leaked, a copy only shares the root box
+    const Node copy = state;
+    CHECK(&copy.get<Sequence>() == &view.get<Sequence>());
+
+    const Node mixed = parse_str("mixed { items: [1, 'a'], { nested: [[1, 'a']] } }");
+    const Node mixed_copy = mixed;
+    CHECK(&mixed_copy.get<Sequence>() == &mixed.get<Sequence>());
+    CHECK(&mixed_copy.get<Sequence>()[1].at("nested").get<Array>() ==
+          &mixed.get<Sequence>()[1].at("nested").get<Array>());
+  }
+
+  SECTION("snapshots") {
+    state.share();
+    const Node snapshot = state;
+    CHECK(&snapshot.at("world") == &view.at("world"));
+
+    state.at("player")["x"] = 2;
+    CHECK(snapshot.at("player").at("x").get<int>() == 1);
+    CHECK(view.at("player").at("x").get<int>() == 2);
+
+    // Only the path to the modified value was copied
+    CHECK(&snapshot.at("player") != &view.at("player"));
+    CHECK(&snapshot.at("player").at("items").get<Array>() ==
+          &view.at("player").at("items").get<Array>());
+    CHECK(&snapshot.at("world").get<Sequence>() == &view.at("world").get<Sequence>());
+  }
+}
+
+TEST_CASE("Node: packed arrays") {
+  Node node = parse_str(
+    "arrays { ints: [1, 2, 3], names: ['a', 'b'], mixed: [1, 'a'], nested: [[true]] }");
+  const Node &view = node;
+
+  // Smaller than PackedArray::PACK_THRESHOLD, packed explicitly
+  CHECK_FALSE(view.at("ints").is_packed());
+  CHECK(node.at("ints").pack());
+  CHECK(node.at("names").pack());
+  CHECK_FALSE(node.at("mixed").pack());
+  CHECK(node.at("nested")[0].pack());
+
+  SECTION("parsed") {
+    std::string items = "0";
+
+    for (size_t n = 1; n < PackedArray::PACK_THRESHOLD; n++) {
+      items += sdata::fmt(", {}", n);
+    }
+
+    Node parsed = parse_str(sdata::fmt("parsed {{ small: [1, 2], large: [{}] }}", items));
+    CHECK_FALSE(std::as_const(parsed).at("small").is_packed());
+    CHECK(std::as_const(parsed).at("large").is_packed());
+    CHECK(std::as_const(parsed).at("large").span<int>().size() == PackedArray::PACK_THRESHOLD);
+  }
+
+  SECTION("packed") {
+    CHECK(view.at("ints").is_packed());
+    CHECK(view.at("names").is_packed());
+    CHECK_FALSE(view.at("mixed").is_packed());
+    CHECK(view.at("nested")[0].is_packed());
+
+    std::span<const int> ints = view.at("ints").span<int>();
+    CHECK(std::vector<int>(ints.begin(), ints.end()) == std::vector<int> {1, 2, 3});
+    CHECK(view.at("names").span<std::string>()[1] == "b");
+    CHECK_THROWS_AS(view.at("ints").span<float>(), VariantException);
+    CHECK_THROWS_AS(view.at("mixed").span<int>(), VariantException);
+  }
+
+  SECTION("generic access") {
+    CHECK(view.at("ints")[2].get<int>() == 3);
+    CHECK(view.at("ints") == Variant {Array {1, 2, 3}});
+    CHECK(Writer(view, Format::inlined()).buffer() ==
+          Writer(parse_str(Writer(view, Format::inlined()).buffer()), Format::inlined()).buffer());
+
+    node.at("ints")[0] = 0;
+    CHECK_FALSE(view.at("ints").is_packed());
+    CHECK(node.at("ints").pack());
+    CHECK(view.at("ints").span<int>()[0] == 0);
+  }
+
+  SECTION("insertion") {
+    node.at("ints").push_back(4);
+    CHECK(view.at("ints").span<int>().size() == 4);
+    CHECK(view.at("ints")[3].get<int>() == 4);
+
+    node.at("ints").push_back("five");
+    CHECK_FALSE(view.at("ints").is_packed());
+    CHECK(view.at("ints") == Variant {Array {1, 2, 3, 4, "five"}});
+  }
+
+  SECTION("mutable span") {
+    Node copy = node;
+    node.at("ints").span<int>()[1] = 20;
+    CHECK(view.at("ints")[1].get<int>() == 20);
+    CHECK(copy.at("ints")[1].get<int>() == 2);
+  }
+}
+
+TEST_CASE("Node: indexed sequence") {
+  Node node {"root", Sequence {}};
+  auto id = [](size_t n) {
+    return sdata::fmt("m{}", n);
+  };
+
+  for (size_t n = 0; n < 200; n++) {
+    node.insert(id(n), static_cast<int>(n));
+  }
+
+  const Node &view = node;
+
+  SECTION("lookup") {
+    for (size_t n = 0; n < 200; n++) {
+      CHECK(view.at(id(n)).get<int>() == static_cast<int>(n));
+    }
+    CHECK(view.search("missing") == nullptr);
+    CHECK(node.get<Sequence>()[150].id() == "m150");
+  }
+
+  SECTION("update keeps the insertion order") {
+    node["m10"] = 42;
+    node.insert("m10", 43);
+    CHECK(node.get<Sequence>().size() == 200);
+    CHECK(node.get<Sequence>()[10].get<int>() == 43);
+  }
+
+  SECTION("renamed member") {
+    node.at("m5").rename("renamed");
+    CHECK(view.search("m5") == nullptr);
+    CHECK(view.at("renamed").get<int>() == 5);
+
+    node.get<Sequence>()[6] = Node {"assigned", 6};
+    CHECK(node.search("m6") == nullptr);
+    CHECK(node.at("assigned").get<int>() == 6);
+  }
+
+  SECTION("erased member") {
+    Sequence &sequence = node.get<Sequence>();
+    sequence.erase(sequence.begin());
+    CHECK(view.search("m0") == nullptr);
+    CHECK(&view.at("m1") == &sequence[0]);
+
+    sequence.pop_back();
+    sequence.push_back(Node {"last", 1});
+    CHECK(view.search("m199") == nullptr);
+    CHECK(view.at("last").get<int>() == 1);
+  }
+
+  SECTION("duplicated identifier") {
+    node.get<Sequence>().emplace_back("m3", 0);
+    CHECK(view.at("m3").get<int>() == 3);
+  }
+
+  SECTION("renames through member references") {
+    Node other {"other", Sequence {}};
+
+    for (size_t n = 0; n < 100; n++) {
+      other.insert(id(n), 0);
+    }
+
+    // Renames in other sequences only concern the same identifiers
+    other.at("m1").rename("other");
+    other.get<Sequence>()[2] = Node {"assigned", 2};
+    CHECK(view.at("m1").get<int>() == 1);
+    CHECK(view.at("m2").get<int>() == 2);
+    CHECK(view.search("other") == nullptr);
+
+    // Lookups between taking the references and renaming
+    Node &renamed = node.at("m3");
+    node.at("m4");
+    renamed.rename("zz");
+    CHECK(view.search("zz") == &renamed);
+    CHECK(node.search("zz") == &renamed);
+    CHECK(node.search("m3") == nullptr);
+
+    Node &assigned = node.at("m5");
+    node.at("m6");
+    assigned = Node {"yy", 1};
+    CHECK(view.search("yy") == &assigned);
+    CHECK(node.search("yy") == &assigned);
+    CHECK(view.search("m5") == nullptr);
+
+    // A member renamed to an identifier indexed further is found first
+    Node &first = node.at("m7");
+    first.rename("m20");
+    CHECK(view.search("m20") == &first);
+    CHECK(node.search("m20") == &first);
+    first.rename("m7");
+    CHECK(node.at("m20").get<int>() == 20);
+    CHECK(view.at("m7").get<int>() == 7);
+
+    for (Node &member : node.get<Sequence>()) {
+      member.rename(sdata::fmt("{}x", member.id()));
+    }
+    CHECK(view.at("m8x").get<int>() == 8);
+    CHECK(node.search("m8") == nullptr);
+    CHECK(node.at("m9x").get<int>() == 9);
+    CHECK(view.get<Sequence>().is_indexed());
+  }
+
+  SECTION("copy") {
+    Node copy = node;
+    copy.at("m7").rename("copied");
+    CHECK(copy.at("copied").get<int>() == 7);
+    CHECK(view.at("m7").get<int>() == 7);
+  }
+}
+
+TEST_CASE("Node: structural hash") {
+  Node config = parse_str("config { window { width: 1920, scale: 0.0 }, tags: ['a', 'b'] }");
+  config.at("tags").pack();
+  config.share();
+
+  SECTION("equal trees") {
+    Node built {"config", {
+      Node {"window", {Node {"width", 1920}, Node {"scale", -0.0f}}},
+      Node {"tags", Array {String {"a"}, String {"b"}}},
+    }};
+
+    CHECK(!built.at("tags").is_packed());
+    CHECK(config.at("tags").is_packed());
+    CHECK(built.hash() == config.hash());
+    CHECK(built == config);
+
+    Node copy = config;
+    CHECK(copy.hash() == config.hash());
+    CHECK(copy == config);
+  }
+
+  SECTION("different trees") {
+    Node tag = parse_str("config { window { width: 1920, scale: 0.0 }, tags: ['a'] }");
+    Node renamed = parse_str("config { window { height: 1920, scale: 0.0 }, tags: ['a', 'b'] }");
+
+    CHECK(config.hash() != tag.hash());
+    CHECK(config.hash() != renamed.hash());
+    CHECK(Node {"a", 1}.hash() != Node {"b", 1}.hash());
+    CHECK(Node {"a", 1}.hash() != Node {"a", true}.hash());
+    CHECK(Variant {Array {}}.hash() != Variant {Sequence {}}.hash());
+  }
+
+  SECTION("mutation path") {
+    const Node &view = config;
+    Node copy = config;
+    uint64_t hash = config.hash();
+
+    Node resized = parse_str("config { window { width: 1080, scale: 0.0 }, tags: ['a', 'b'] }");
+    config.at("window").at("width") = 1080;
+    config.share();
+
+    CHECK(config.hash() != hash);
+    CHECK(config.hash() == resized.hash());
+    CHECK(config == resized);
+    CHECK(copy.hash() == hash);
+    CHECK(copy != config);
+
+    Node tags {"tags", Array {String {"a"}, String {"b"}, String {"c"}}};
+    config.at("tags").push_back(String {"c"});
+    CHECK(view.at("tags").hash() == tags.hash());
+  }
+}
+
 #endif
@@ -0,0 +1,65 @@
+#ifndef SDATA_PARALLEL_PARSER_TEST_HPP
+#define SDATA_PARALLEL_PARSER_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+static std::string parallel_source(size_t count) {
+  std::string source = "# generated, with {[ tricky ]} comments #\nentities {\n";
+
+  for (size_t i = 0; i < count; i++) {
+    source += sdata::fmt(
+      "  e{} {{ name: 'entity, {{{}}}', tags: [{}, {}.5, \"]\", nil, [true]] }}{}\n",
+      i,
+      i,
+      i,
+      i,
+      i + 1 < count ? "," : "");
+  }
+
+  return source + "}";
+}
+
+static std::string parallel_message(std::string_view source, size_t thread_count) {
+  try {
+    parse_parallel(source, thread_count);
+  } catch (const std::exception &exception) {
+    return exception.what();
+  }
+  return {};
+}
+
+TEST_CASE("ParallelParser") {
+  SECTION("sequence") {
+    std::string source = parallel_source(1000);
+    CHECK(parse_parallel(source, 4) == parse_str(source));
+    CHECK(parse_parallel(source, 4).get<Sequence>().size() == 1000);
+  }
+
+  SECTION("array") {
+    std::string source = "numbers: [";
+
+    for (int i = 0; i < 1000; i++) {
+      source += sdata::fmt("{}{}", i, i < 999 ? ", " : "]");
+    }
+
+    CHECK(parse_parallel(source, 4) == parse_str(source));
+    CHECK(parse_parallel(source, 4)[999] == Variant {999});
+  }
+
+  SECTION("small documents") {
+    CHECK(parse_parallel("a { b: 1 }", 4) == parse_str("a { b: 1 }"));
+  }
+
+  SECTION("errors") {
+    std::string source = parallel_source(1000);
+    source.replace(source.find("e500 {"), 6, "e500 :");
+
+    CHECK_THROWS_AS(parse_str(source), ParserException);
+    CHECK(parallel_message(source, 4) == parallel_message(source, 1));
+  }
+}
+
+#endif
@@ -1,9 +1,11 @@
 #ifndef SDATA_PARSER_TEST_HPP
 #define SDATA_PARSER_TEST_HPP
 
+#include "allocations.hpp"
 #include <catch2/catch.hpp>
 #include <sdata/sdata.hpp>
 #include <sstream>
+#include <thread>
 
 using namespace sdata;
 
@@ -102,4 +104,378 @@ TEST_CASE("Parser") {
   CHECK(parse_file("examples/features.sd") == features);
 }
 
+TEST_CASE("Parser: borrow") {
+  std::string source = read_file("examples/dialog.sd");
+  Node node = parse_str(source, {.borrow = true});
+
+  auto borrowed = [&source](std::string_view view) {
+    return view.data() >= source.data() && view.data() + view.size() <= source.data() + source.size();
+  };
+
+  CHECK(node == dialog);
+
+  const Node &title = node.at("fr_FR").at("title");
+  CHECK(title.atom() == Atom {"title"});
+  CHECK(borrowed(title.get<std::string>()));
+  CHECK(title.get<std::string>().is_borrowed());
+
+  // Copies owning their data survive the source
+  Node owned = title;
+  owned.get<std::string>().own();
+  CHECK_FALSE(borrowed(owned.get<std::string>()));
+  CHECK(owned.get<std::string>() == "Partie terminée");
+}
+
+TEST_CASE("Parser: escape sequences") {
+  Node format = parse_str(R"(standard { separator: ',\n', bounds: ['{\n\n', '\n}'] })");
+  CHECK(format.at("separator").get<std::string>() == ",\n");
+  CHECK(format.at("bounds")[0].get<std::string>() == "{\n\n");
+
+  CHECK(parse_str(R"(a: 'tab\t, backslash\\')") == Node {"a", "tab\t, backslash\\"});
+  CHECK(parse_str(R"(a: 'trailing\')") == Node {"a", "trailing\\"});
+
+  SECTION("lazy") {
+    std::string_view source = R"(a: 'line\n')";
+    Node node = parse_str(source, {.borrow = true});
+    const String &string = node.get<std::string>();
+
+    CHECK(string.is_borrowed());
+    CHECK(string == "line\n");
+    CHECK_FALSE(string.is_borrowed());
+  }
+
+  SECTION("shared copies") {
+    std::string source = R"(a { b: 'line\n', c: ['tab\t', 'x'], d: [)";
+
+    for (size_t n = 0; n < PackedArray::PACK_THRESHOLD; n++) {
+      source += "'item\\n', ";
+    }
+    source += "'last'] }";
+
+    // The strings of the shared boxes are decoded by the parser, the copies only read them
+    const Node tree = parse_str(source, {.borrow = true});
+    const Node first = tree, second = tree;
+    CHECK_FALSE(tree.at("b").get<String>().is_borrowed());
+    CHECK_FALSE(tree.at("c")[0].get<String>().is_borrowed());
+    CHECK_FALSE(tree.at("d").span<String>()[0].is_borrowed());
+    CHECK(tree.at("c")[1].get<String>().is_borrowed());
+
+    std::vector<std::thread> readers {};
+    std::atomic<size_t> decoded = 0;
+
+    for (const Node *copy : {&first, &second}) {
+      readers.emplace_back([copy, &decoded] {
+        decoded += copy->at("b") == Variant {"line\n"} && copy->at("d")[0] == Variant {"item\n"};
+      });
+    }
+
+    for (std::thread &reader : readers) {
+      reader.join();
+    }
+
+    CHECK(decoded == 2);
+    CHECK(&first.at("b") == &second.at("b"));
+  }
+}
+
+TEST_CASE("Parser: depth") {
+  auto nested = [](size_t depth) {
+    return "a: " + std::string(depth, '[') + "1" + std::string(depth, ']');
+  };
+
+  SECTION("limit") {
+    CHECK_NOTHROW(Parser(nested(256)).parse());
+    CHECK_THROWS_AS(Parser(nested(257)).parse(), ParserException);
+    CHECK_THROWS_AS(Parser("a { b { c: 1 } }", {.max_depth = 1}).parse(), ParserException);
+  }
+
+  SECTION("deep") {
+    Node node = Parser(nested(2000), {.max_depth = 2000}).parse();
+    const Variant *variant = &node;
+
+    for (size_t i = 0; i < 2000; i++) {
+      REQUIRE(variant->is<Array>());
+      variant = &variant->at(0);
+    }
+
+    CHECK(*variant == Variant {1});
+  }
+
+  SECTION("comments") {
+    std::string source {};
+
+    for (size_t i = 0; i < 20000; i++) {
+      source += "# comment #\n";
+    }
+
+    CHECK(parse_str(source + "a: 1") == Node {"a", 1});
+  }
+}
+
+namespace tetris {
+
+struct Window {
+  int width, height;
+  std::string_view title;
+  bool fullscreen;
+};
+
+struct Controls {
+  std::string left, right;
+};
+
+struct Game {
+  Window window;
+  Controls controls;
+};
+
+}  // namespace tetris
+
+template<>
+struct sdata::Serializer<tetris::Window> :
+  Scheme<tetris::Window(int, int, std::string_view, bool)> {
+  Map map(tetris::Window &window) override {
+    return {
+      {"width", window.width},
+      {"height", window.height},
+      {"title", window.title},
+      {"fullscreen", window.fullscreen},
+    };
+  }
+};
+
+template<>
+struct sdata::Serializer<tetris::Controls> : Scheme<tetris::Controls(std::string, std::string)> {
+  Map map(tetris::Controls &controls) override {
+    return {
+      {"left", controls.left},
+      {"right", controls.right},
+    };
+  }
+};
+
+template<>
+struct sdata::Serializer<tetris::Game> : Scheme<tetris::Game(tetris::Window, tetris::Controls)> {
+  Map map(tetris::Game &game) override {
+    return {
+      {"window", game.window},
+      {"controls", game.controls},
+    };
+  }
+};
+
+TEST_CASE("Parser: spans") {
+  std::string_view source = "a { b: 12, c: [nil, 'y'] }";
+  Parser parser {source, {.spans = true}};
+  parser.parse();
+
+  auto text = [&](size_t begin, size_t end) {
+    return source.substr(begin, end - begin);
+  };
+
+  const SourceSpan &a = parser.span();
+  REQUIRE(a.children.size() == 2);
+  CHECK(text(a.begin, a.end) == source);
+  CHECK(text(a.value_begin, a.value_end) == "{ b: 12, c: [nil, 'y'] }");
+
+  const SourceSpan &b = a.children[0];
+  CHECK(text(b.begin, b.end) == "b: 12");
+  CHECK(text(b.value_begin, b.value_end) == "12");
+
+  const SourceSpan &c = a.children[1];
+  REQUIRE(c.children.size() == 2);
+  CHECK(text(c.value_begin, c.value_end) == "[nil, 'y']");
+  CHECK(text(c.children[1].begin, c.children[1].end) == "'y'");
+
+  CHECK(Parser(source).span().children.empty());
+}
+
+TEST_CASE("Parser: numeric arrays") {
+  // Items spans are only recorded by the token path, which serves as the reference
+  auto token_path = [](std::string_view source) {
+    return Parser(source, {.spans = true}).parse();
+  };
+
+  std::string source = "a: [";
+
+  for (int i = 0; i < 1000; i++) {
+    int integer = (i % 2 ? -1 : 1) * i * i * i * 2137;
+    source += sdata::fmt("{},{}{}.{} ,\t", integer, i % 3 ? "" : "-", i * 7919, i);
+  }
+
+  source += "2147483647, -2147483648, 00123456789, -0, 1.17549435, 16777217.0, 0.1]";
+
+  Node node = parse_str(source);
+  REQUIRE(node.get<Array>().size() == 2007);
+  CHECK(node == token_path(source));
+  CHECK(node[2000] == Variant {2147483647});
+  CHECK(node[2001] == Variant {std::numeric_limits<int>::min()});
+  CHECK(node[2002] == Variant {123456789});
+
+  SECTION("mixed") {
+    std::vector<std::string_view> sources {
+      "a: [1, 'b', 2, [3, 4], nil, 5.5, [6]]",
+      "a: [ 1 , 2 # comment # , 3 ]",
+      "a: [[[1, 2], [3]], [4, 5]]",
+      "a { b: [1, 2], c: [3.5] }",
+      "a { b: 1.5f, c: [2.5f, 3, -0.25f] }",
+    };
+
+    for (std::string_view mixed : sources) {
+      CHECK(parse_str(mixed) == token_path(mixed));
+    }
+  }
+
+  SECTION("errors") {
+    CHECK_THROWS_AS(parse_str("a: [1 2]"), ParserException);
+    CHECK_THROWS_AS(parse_str("a: [1, 2147483648]"), Exception);
+    CHECK_THROWS_AS(parse_str("a: [1, +2]"), Exception);
+    CHECK_THROWS_AS(parse_str("a: [1, 2"), ParserException);
+  }
+}
+
+TEST_CASE("Parser: step") {
+  std::string source = "game {";
+
+  for (size_t i = 0; i < 200; i++) {
+    source += sdata::fmt(" e{} {{ name: 'e{}', at: [{}, [{}.5]] }},", i, i, i, i);
+  }
+
+  source += " last: nil }";
+  Node expected = parse_str(source);
+
+  SECTION("tokens") {
+    Parser parser {source};
+    size_t steps = 1;
+
+    while (!parser.step(1)) {
+      steps++;
+    }
+
+    CHECK(parser.result() == expected);
+    CHECK(steps > 1000);
+    CHECK(parser.step(1));
+  }
+
+  SECTION("time") {
+    Parser parser {source};
+
+    while (!parser.step(std::chrono::microseconds {100})) {
+    }
+
+    CHECK(parser.result() == expected);
+  }
+
+  SECTION("empty") {
+    Parser parser {" # nothing # "};
+    CHECK(parser.step(8));
+    CHECK(parser.result() == parse_str(""));
+  }
+
+  SECTION("errors") {
+    Parser parser {"a { b: 1, c: }"};
+    CHECK_FALSE(parser.step(4));
+    CHECK_THROWS_AS(parser.step(8), ParserException);
+  }
+}
+
+TEST_CASE("Parser: parse_into node") {
+  std::string_view source =
+    "state { tick: 1, position: [1.5, 2.5], name: 'player one', { flag: true } }";
+  Node node {""};
+  parse_into(source, node);
+  REQUIRE(node == parse_str(source));
+
+  SECTION("same shape") {
+    const Node *members = node.get<Sequence>().data();
+    const Variant *position = node.at("position").get<Array>().data();
+    const char *name = node.at("name").get<String>().data();
+
+    parse_into("state { tick: 2, position: [3.5, 4.5], name: 'player two', { flag: false } }", node);
+
+    CHECK(node.at("tick").get<int>() == 2);
+    CHECK(node.at("position")[1].get<float>() == 4.5f);
+    CHECK(node.at("name").get<String>() == "player two");
+    CHECK(node.get<Sequence>().data() == members);
+    CHECK(node.at("position").get<Array>().data() == position);
+    CHECK(node.at("name").get<String>().data() == name);
+  }
+
+  SECTION("warm allocations") {
+    parse_into("state { tick: 2, position: [3.5, 4.5], name: 'player two', { flag: false } }", node);
+
+    size_t warm = count_allocations([&] {
+      parse_into(source, node);
+    });
+    size_t cold = count_allocations([&] {
+      parse_str(source);
+    });
+
+    CHECK(warm == 0);
+    CHECK(cold > 0);
+    CHECK(node == parse_str(source));
+  }
+
+  SECTION("different shape") {
+    std::vector<std::string_view> sources {
+      "state { tick: [1, [2]], other { a: 'b\\tc' } }",
+      "{ tick: 1, position: nil }",
+      "state: [[1], 2]",
+      "state: 'x'",
+      source,
+    };
+
+    for (std::string_view other : sources) {
+      parse_into(other, node);
+      CHECK(node == parse_str(other));
+    }
+  }
+
+  SECTION("borrowed") {
+    std::string borrowed {source};
+    Node tree = parse_str(borrowed, {.borrow = true});
+    parse_into(source, tree);
+    borrowed.assign(borrowed.size(), '_');
+
+    CHECK(tree == parse_str(source));
+  }
+
+  SECTION("errors") {
+    CHECK_THROWS_AS(parse_into("state { tick: }", node), ParserException);
+    CHECK_THROWS_AS(Parser("a: [[1]]", {.max_depth = 1}).parse_into(node), ParserException);
+  }
+}
+
+TEST_CASE("Parser: parse_into") {
+  SECTION("scheme") {
+    auto source = read_file("examples/game.sd");
+    tetris::Game tetris {};
+    parse_into(source, tetris);
+
+    CHECK(tetris.window.width == 1920);
+    CHECK(tetris.window.height == 1080);
+    CHECK(tetris.window.title == "Tetris game");
+    CHECK(tetris.window.fullscreen == false);
+    CHECK(tetris.controls.left == "a");
+    CHECK(tetris.controls.right == "d");
+  }
+
+  SECTION("unknown members") {
+    tetris::Window window {};
+    parse_into("{ a { b: [1, [2]] }, width: 2, height: 1, title: 't', fullscreen: true }", window);
+
+    CHECK(window.width == 2);
+    CHECK(window.height == 1);
+    CHECK(window.title == "t");
+    CHECK(window.fullscreen == true);
+  }
+
+  SECTION("errors") {
+    tetris::Window window {};
+    CHECK_THROWS_AS(parse_into("w { width: 2, height: 1 }", window), ParserException);
+    CHECK_THROWS_AS(parse_into("w { width: 'a' }", window), VariantException);
+    CHECK_THROWS_AS(parse_into("w: 2", window), ParserException);
+  }
+}
+
 #endif
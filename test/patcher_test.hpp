@@ -0,0 +1,73 @@
+#ifndef SDATA_PATCHER_TEST_HPP
+#define SDATA_PATCHER_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("Patcher") {
+  std::string source =
+    "game {\n"
+    "  # window settings #\n"
+    "  window {\n"
+    "    width:   1920, # pixels #\n"
+    "    title: 'a, {b}'\n"
+    "  },\n"
+    "  volume: 0.5\n"
+    "}\n";
+
+  SECTION("values") {
+    std::string patched = patch_str(source, {{"window.width", 1280}, {"volume", "loud"}});
+
+    CHECK(patched ==
+          "game {\n"
+          "  # window settings #\n"
+          "  window {\n"
+          "    width:   1280, # pixels #\n"
+          "    title: 'a, {b}'\n"
+          "  },\n"
+          "  volume: 'loud'\n"
+          "}\n");
+  }
+
+  SECTION("syntax") {
+    Node expected = parse_str(source);
+    expected.at("window") = 1;
+    expected.at("volume") = Sequence {{"level", 2}};
+
+    std::string patched = patch_str(source, {{"volume", Sequence {{"level", 2}}}, {"window", 1}});
+    CHECK(parse_str(patched) == expected);
+  }
+
+  SECTION("in place") {
+    Patcher patcher {source};
+    CHECK(patcher.set("window.title", "a, {c}").is_in_place());
+    CHECK_FALSE(patcher.set("volume", 0.25f).is_in_place());
+    CHECK(patcher.edits().size() == 2);
+  }
+
+  SECTION("errors") {
+    CHECK_THROWS_AS(patch_str(source, {{"window.height", 1}}), PatcherException);
+    CHECK_THROWS_AS(patch_str(source, {{"volume.level", 1}}), PatcherException);
+    CHECK_THROWS_AS(patch_str(source, {{"window", 1}, {"window.width", 2}}), PatcherException);
+    CHECK_THROWS_AS(patch_str("a { b: 'c }", {{"b", 1}}), ParserException);
+  }
+
+  SECTION("file") {
+    auto path = std::filesystem::temp_directory_path() / "sdata_patcher_test.sd";
+    std::ofstream {path} << source;
+
+    patch_file(path, {{"window.width", 2560}});
+    CHECK(read_file(path).size() == source.size());
+    CHECK(parse_file(path).at("window").at("width").get<int>() == 2560);
+
+    patch_file(path, {{"window.width", 640}});
+    CHECK(read_file(path).size() == source.size() - 1);
+    CHECK(parse_file(path).at("window").at("width").get<int>() == 640);
+
+    std::filesystem::remove(path);
+  }
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SDATA_PATH_TEST_HPP
+#define SDATA_PATH_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("Path") {
+  Node service = parse_str(R"(
+    service {
+      name: 'api',
+      routes {
+        users { methods: ['GET', 'POST'], limit: 100 },
+        posts { methods: ['GET'], limit: 50 },
+        { limit: 10 }
+      },
+      ports: [[80, 443], [8080]]
+    })");
+
+  SECTION("compilation") {
+    Path path {"routes.users.methods[1]"};
+    CHECK(path.steps().size() == 4);
+    CHECK(path.steps()[1].id == Atom {"users"});
+    CHECK(path.steps()[3].kind == PathStep::INDEX);
+    CHECK(path.steps()[3].index == 1);
+    CHECK(Path {"routes.*.limit"}.steps()[1].kind == PathStep::WILDCARD);
+    CHECK(Path {"ports[*][0]"}.steps()[1].kind == PathStep::WILDCARD);
+    CHECK(Path {""}.steps().empty());
+
+    CHECK_THROWS_AS(Path {"routes..users"}, PathException);
+    CHECK_THROWS_AS(Path {".routes"}, PathException);
+    CHECK_THROWS_AS(Path {"routes."}, PathException);
+    CHECK_THROWS_AS(Path {"ports[0"}, PathException);
+    CHECK_THROWS_AS(Path {"ports[-1]"}, PathException);
+    CHECK_THROWS_AS(Path {"ports[]"}, PathException);
+    CHECK_THROWS_AS(Path {"ports[0]x"}, PathException);
+    CHECK_THROWS_AS(Path {"na-me"}, PathException);
+  }
+
+  SECTION("select") {
+    CHECK(Path {"routes.users.methods[1]"}.find(service)->get<String>() == "POST");
+    CHECK(Path {"routes[2].limit"}.find(service)->get<int>() == 10);
+    CHECK(Path {"ports[1][0]"}.find(service)->get<int>() == 8080);
+    CHECK(Path {""}.find(service) == &service);
+    CHECK(Path {"routes.audio"}.find(service) == nullptr);
+    CHECK(Path {"name.methods"}.find(service) == nullptr);
+    CHECK(Path {"ports[2]"}.find(service) == nullptr);
+
+    auto limits = Path {"routes.*.limit"}.select(service);
+    REQUIRE(limits.size() == 3);
+    CHECK(limits[0]->get<int>() == 100);
+    CHECK(limits[1]->get<int>() == 50);
+    CHECK(limits[2]->get<int>() == 10);
+
+    auto ports = Path {"ports[*][*]"}.select(service);
+    REQUIRE(ports.size() == 3);
+    CHECK(ports[2]->get<int>() == 8080);
+    CHECK(Path {"*.methods[0]"}.find(service.at("routes")) != nullptr);
+    CHECK(Path {"routes.*.methods[0]"}.find(service)->get<String>() == "GET");
+  }
+
+  SECTION("query") {
+    Query query {{"name", "routes.*.limit", "routes.users.limit", "ports[0][1]", "audio"}};
+    CHECK(query.size() == 5);
+
+    Query::Matches matches = query.evaluate(service);
+    REQUIRE(matches.size() == 5);
+    CHECK(matches[0][0]->get<String>() == "api");
+    CHECK(matches[1].size() == 3);
+    CHECK(matches[2].size() == 1);
+    CHECK(matches[2][0] == matches[1][0]);
+    CHECK(matches[3][0]->get<int>() == 443);
+    CHECK(matches[4].empty());
+    CHECK(query.add(Path {"routes.posts"}) == 5);
+
+    // The cached positions are checked against the reordered members
+    Node reordered = parse_str(R"(
+      service {
+        routes { posts { limit: 5 }, users { limit: 6 } },
+        name: 'web'
+      })");
+
+    query.evaluate(reordered, matches);
+    CHECK(matches[0][0]->get<String>() == "web");
+    CHECK(matches[1].size() == 2);
+    CHECK(matches[2][0]->get<int>() == 6);
+    CHECK(matches[3].empty());
+    CHECK(matches[5][0] == &reordered.at("routes").at("posts"));
+
+    query.evaluate(service, matches);
+    CHECK(matches[2][0]->get<int>() == 100);
+  }
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SDATA_PUSH_PARSER_TEST_HPP
+#define SDATA_PUSH_PARSER_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("PushParser") {
+  PushParser parser {};
+
+  auto push = [&](std::string_view source, size_t chunk_size) {
+    std::vector<Node> nodes {};
+
+    for (size_t n = 0; n < source.size(); n += chunk_size) {
+      parser.feed(source.substr(n, chunk_size));
+
+      while (auto node = parser.next()) {
+        nodes.push_back(std::move(*node));
+      }
+    }
+
+    parser.finish();
+
+    while (auto node = parser.next()) {
+      nodes.push_back(std::move(*node));
+    }
+
+    return nodes;
+  };
+
+  SECTION("chunks") {
+    std::string source =
+      "# a {'[# event { id: 1, name: 'click #1', at: [1, 2.25] }\n"
+      "level: 12345 title: \"a 'b' }\" { anonymous: [[true], nil] }\n"
+      "last: false";
+    std::vector<Node> expected = parse_records(source);
+    REQUIRE(expected.size() == 5);
+
+    for (size_t chunk_size : {1, 2, 3, 7, 64}) {
+      CHECK(push(source, chunk_size) == expected);
+    }
+  }
+
+  SECTION("emission") {
+    parser.feed("a { b: 1 } c: 12");
+    CHECK(parser.next() == Node {"a", {{"b", 1}}});
+    // The number may continue in the next chunk
+    CHECK_FALSE(parser.next());
+
+    parser.feed("3 d: 'x");
+    CHECK(parser.next() == Node {"c", 123});
+    CHECK_FALSE(parser.next());
+
+    parser.feed("y'");
+    CHECK(parser.next() == Node {"d", "xy"});
+  }
+
+  SECTION("errors") {
+    parser.feed("a: 1 b { c: }");
+    CHECK(parser.next() == Node {"a", 1});
+    CHECK_THROWS_AS(parser.next(), ParserException);
+
+    parser.feed(" d { e: 1 ");
+    parser.finish();
+    CHECK_THROWS_AS(parser.next(), ParserException);
+    CHECK_FALSE(parser.next());
+  }
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SDATA_RECORD_READER_TEST_HPP
+#define SDATA_RECORD_READER_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+#include <sstream>
+
+using namespace sdata;
+
+static std::string record_source(size_t count) {
+  std::string source {};
+
+  for (size_t i = 0; i < count; i++) {
+    source += sdata::fmt("event {{ id: {}, name: 'click #{}', at: [{}, 2.25] }}\n", i, i, i);
+    source += sdata::fmt("# separator # level: {}\n", i);
+  }
+
+  return source;
+}
+
+TEST_CASE("Parser: records") {
+  Parser parser {"a: 1 b { c: 'd' } { e: nil }"};
+
+  CHECK(parser.parse_next() == Node {"a", 1});
+  CHECK(parser.parse_next() == Node {"b", {{"c", "d"}}});
+  CHECK(parser.parse_next() == Node {"", {{"e", nullptr}}});
+  CHECK_FALSE(parser.parse_next());
+}
+
+TEST_CASE("RecordReader") {
+  std::string source = record_source(200);
+  std::vector<Node> expected = parse_records(source);
+  REQUIRE(expected.size() == 400);
+
+  SECTION("parallel batches") {
+    CHECK(parse_records(source, 4) == expected);
+  }
+
+  SECTION("stream") {
+    // Small blocks split the tokens between reads
+    std::istringstream stream {source};
+    RecordReader reader {stream, 7};
+    std::vector<Node> records {};
+
+    while (auto record = reader.next()) {
+      records.push_back(std::move(*record));
+    }
+
+    CHECK(records == expected);
+  }
+
+  SECTION("stream batches") {
+    std::istringstream stream {source};
+    RecordReader reader {stream, 64};
+    std::vector<Node> records {};
+
+    for (auto batch = reader.next_batch(150, 4); !batch.empty(); batch = reader.next_batch(150, 4)) {
+      CHECK(batch.size() <= 150);
+      records.insert(records.end(), batch.begin(), batch.end());
+    }
+
+    CHECK(records == expected);
+  }
+
+  SECTION("truncated stream") {
+    std::istringstream stream {"a: 1 b { c: 2"};
+    RecordReader reader {stream, 4};
+
+    CHECK(reader.next() == Node {"a", 1});
+    CHECK_THROWS_AS(reader.next(), ParserException);
+  }
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef SDATA_TRAVERSAL_TEST_HPP
+#define SDATA_TRAVERSAL_TEST_HPP
+
+#include <catch2/catch.hpp>
+#include <sdata/sdata.hpp>
+
+using namespace sdata;
+
+TEST_CASE("Traversal") {
+  Node tree = parse_str("a { b { c: 1, d: [2, 'x'] }, e: 3.5, { f: true } }");
+
+  SECTION("depth-first") {
+    std::vector<std::string> visited {};
+
+    for (const Visited &value : Traversal {tree}) {
+      visited.push_back(sdata::fmt("{}:{}:{}", value.id, value.index, value.depth));
+    }
+
+    CHECK(visited == std::vector<std::string> {
+      "a:0:0", "b:0:1", "c:0:2", "d:1:2", ":0:3", ":1:3", "e:1:1", ":2:1", "f:0:2",
+    });
+  }
+
+  SECTION("breadth-first") {
+    std::vector<std::string_view> ids {};
+    std::vector<size_t> depths {};
+
+    for (const Visited &value : Traversal {tree, Traversal::BREADTH_FIRST}) {
+      ids.push_back(value.id);
+      depths.push_back(value.depth);
+    }
+
+    CHECK(ids == std::vector<std::string_view> {"a", "b", "e", "", "c", "d", "f", "", ""});
+    CHECK(std::is_sorted(depths.begin(), depths.end()));
+  }
+
+  SECTION("visitor") {
+    int ints = 0;
+    size_t containers = 0;
+    std::string strings {};
+
+    Traversal traversal {};
+    bool is_complete = traversal.visit(tree, [&]<typename A>(const Visited &, const A &value) {
+      if constexpr (std::same_as<A, int>) {
+        ints += value;
+      } else if constexpr (std::same_as<A, String>) {
+        strings += value.view();
+      } else if constexpr (any_of<A, Array, Sequence>) {
+        containers++;
+      }
+    });
+
+    CHECK(is_complete);
+    CHECK(ints == 3);
+    CHECK(strings == "x");
+    CHECK(containers == 4);
+
+    // Stopped at the first float, the traversal is reused
+    std::string_view stopped {};
+    is_complete = traversal.visit(tree, [&]<typename A>(const Visited &visited, const A &) {
+      stopped = visited.id;
+      return !std::same_as<A, float>;
+    });
+
+    CHECK_FALSE(is_complete);
+    CHECK(stopped == "e");
+  }
+
+  SECTION("deep tree") {
+    constexpr size_t DEPTH = 10000;
+    Node deep {"deep"};
+
+    for (size_t n = 0; n < DEPTH; n++) {
+      deep = Node {"deep", {std::move(deep)}};
+    }
+
+    size_t depth = 0;
+
+    for (const Visited &value : Traversal {deep}) {
+      depth = std::max(depth, value.depth);
+    }
+
+    CHECK(depth == DEPTH);
+  }
+}
+
+#endif
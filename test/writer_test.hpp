@@ -19,4 +19,32 @@ TEST_CASE("Writer") {
   CHECK(test_writer("examples/features.sd"));
 }
 
+TEST_CASE("Writer: escaped strings") {
+  Node node {"paths", {
+    Node {"windows", "C:\\new\\table"},
+    Node {"quoted", "it's \"quoted\""},
+    Node {"lines", "a\n\tb\r"},
+    Node {"items", Array {String {"x'y"}, String {"\\"}}},
+  }};
+
+  std::string written = write_str(node, Format::inlined());
+  CHECK(written.find(R"('C:\\new\\table')") != std::string::npos);
+  CHECK(written.find(R"('it\'s "quoted"')") != std::string::npos);
+  CHECK(written.find('\n') == std::string::npos);
+
+  CHECK(parse_str(written) == node);
+  CHECK(parse_str(write_str(node)) == node);
+  CHECK(parse_str(written, {.borrow = true}) == node);
+  CHECK(escape("a'b\\", '\'') == R"(a\'b\\)");
+  CHECK(unescape(escape("\a\b\f\n\r\t\v\\'\"", '"')) == "\a\b\f\n\r\t\v\\'\"");
+
+  // The readers skimming the strings don't stop at an escaped quote
+  CHECK(extract(written, {"items"}).at("items") == node.at("items"));
+
+  PushParser push_parser {};
+  push_parser.feed(written);
+  push_parser.finish();
+  CHECK(push_parser.next() == node);
+}
+
 #endif